@@ -0,0 +1,254 @@
+#include <stream-client/stream-client.hpp>
+
+#include <benchmark/benchmark.h>
+
+#include <boost/asio.hpp>
+#include <boost/beast.hpp>
+
+#include <atomic>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace {
+
+/**
+ * Minimal in-process server to benchmark against.
+ * Accepts connections on a loopback ephemeral port and serves each one in
+ * a dedicated thread until the client disconnects. Unlike tests/utils/echo_server.hpp
+ * sessions are persistent, so a single connection survives millions of iterations.
+ */
+class acceptor_server
+{
+public:
+    using socket_type = boost::asio::ip::tcp::socket;
+
+    acceptor_server()
+        : acceptor_(io_service_)
+    {
+        const boost::asio::ip::tcp::endpoint endpoint(boost::asio::ip::address_v4::loopback(), 0);
+        acceptor_.open(endpoint.protocol());
+        acceptor_.set_option(boost::asio::socket_base::reuse_address(true));
+        acceptor_.bind(endpoint);
+        acceptor_.listen(boost::asio::socket_base::max_connections);
+        accept_thread_ = std::thread([this]() { this->accept_loop(); });
+    }
+
+    acceptor_server(const acceptor_server& other) = delete;
+    acceptor_server& operator=(const acceptor_server& other) = delete;
+
+    virtual ~acceptor_server()
+    {
+        // closing the acceptor does not unblock a synchronous accept() on Linux,
+        // wake the loop up with a throwaway connection instead
+        stopped_.store(true);
+        boost::system::error_code ec;
+        socket_type dummy(io_service_);
+        dummy.connect(acceptor_.local_endpoint(), ec);
+        if (accept_thread_.joinable()) {
+            accept_thread_.join();
+        }
+        acceptor_.close(ec);
+        for (auto& session : sessions_) {
+            if (session.thread.joinable()) {
+                session.thread.join();
+            }
+        }
+    }
+
+    std::string host() const
+    {
+        return "127.0.0.1";
+    }
+
+    std::string port() const
+    {
+        return std::to_string(acceptor_.local_endpoint().port());
+    }
+
+    boost::asio::ip::tcp::endpoint endpoint() const
+    {
+        return acceptor_.local_endpoint();
+    }
+
+protected:
+    /// Serve single accepted connection; runs in a dedicated thread.
+    virtual void serve(socket_type& socket) = 0;
+
+private:
+    struct session
+    {
+        std::thread thread;
+        std::shared_ptr<std::atomic<bool>> done;
+    };
+
+    void accept_loop()
+    {
+        while (true) {
+            auto socket = std::make_shared<socket_type>(io_service_);
+            boost::system::error_code ec;
+            acceptor_.accept(*socket, ec);
+            if (ec || stopped_.load()) {
+                return;
+            }
+
+            auto done = std::make_shared<std::atomic<bool>>(false);
+            sessions_.push_back(session{std::thread([this, socket, done]() {
+                                            this->serve(*socket);
+                                            done->store(true);
+                                        }),
+                                        done});
+
+            // reap finished sessions to keep the thread list from growing
+            for (auto it = sessions_.begin(); it != sessions_.end();) {
+                if (it->done->load()) {
+                    it->thread.join();
+                    it = sessions_.erase(it);
+                } else {
+                    ++it;
+                }
+            }
+        }
+    }
+
+    boost::asio::io_service io_service_;
+    boost::asio::ip::tcp::acceptor acceptor_;
+    std::atomic<bool> stopped_{false};
+    std::thread accept_thread_;
+    std::list<session> sessions_;
+};
+
+/// Echoes raw bytes back until the client disconnects.
+class echo_server: public acceptor_server
+{
+protected:
+    void serve(socket_type& socket) override
+    {
+        std::vector<char> data(64 * 1024);
+        boost::system::error_code ec;
+        while (!ec) {
+            const auto recv_bytes = socket.read_some(boost::asio::buffer(data), ec);
+            if (ec) {
+                break;
+            }
+            boost::asio::write(socket, boost::asio::buffer(data.data(), recv_bytes), ec);
+        }
+    }
+};
+
+/// Responds to every HTTP request with 200 OK carrying the request body back.
+class http_echo_server: public acceptor_server
+{
+protected:
+    void serve(socket_type& socket) override
+    {
+        boost::system::error_code ec;
+        while (!ec) {
+            boost::beast::flat_buffer buffer{8192};
+            boost::beast::http::request<boost::beast::http::string_body> request;
+            boost::beast::http::read(socket, buffer, request, ec);
+            if (ec) {
+                break;
+            }
+            boost::beast::http::response<boost::beast::http::string_body> response(boost::beast::http::status::ok,
+                                                                                   request.version(), request.body());
+            response.prepare_payload();
+            boost::beast::http::write(socket, response, ec);
+        }
+    }
+};
+
+constexpr std::size_t kPoolSize = 32;
+
+/// Echo server with a session pool connected to it; shared by all benchmark threads.
+struct pool_env
+{
+    pool_env()
+        : pool(kPoolSize, server.host(), server.port(), std::chrono::seconds(1), std::chrono::seconds(1),
+               std::chrono::seconds(5))
+    {
+        boost::system::error_code ec;
+        pool.is_connected(ec, std::chrono::seconds(5));
+    }
+
+    echo_server server;
+    stream_client::connector::tcp_pool pool;
+};
+
+} // anonymous namespace
+
+/// get_session()/return_session() round-trip on a warm pool.
+static void BM_PoolSessionRoundTrip(benchmark::State& state)
+{
+    static pool_env env;
+
+    for (auto _ : state) {
+        auto session = env.pool.get_session();
+        benchmark::DoNotOptimize(session);
+        env.pool.return_session(std::move(session));
+    }
+}
+BENCHMARK(BM_PoolSessionRoundTrip)->Threads(1)->Threads(8)->Threads(32);
+
+/// tcp_client send()+receive() echo round-trip for various payload sizes.
+static void BM_TcpEchoRoundTrip(benchmark::State& state)
+{
+    static echo_server server;
+
+    const std::size_t payload_size = state.range(0);
+    std::string send_data(payload_size, 'x');
+    std::string recv_data(payload_size, '\0');
+
+    stream_client::tcp_client client(server.endpoint(), std::chrono::seconds(1), std::chrono::seconds(5));
+    for (auto _ : state) {
+        client.send(boost::asio::buffer(send_data.data(), send_data.size()));
+        const auto recv_bytes = client.receive(boost::asio::buffer(&recv_data[0], recv_data.size()));
+        benchmark::DoNotOptimize(recv_bytes);
+    }
+    state.SetBytesProcessed(state.iterations() * payload_size * 2);
+}
+BENCHMARK(BM_TcpEchoRoundTrip)->Arg(64)->Arg(4 * 1024)->Arg(64 * 1024);
+
+/// http_client perform() request/response round-trip.
+static void BM_HttpPerform(benchmark::State& state)
+{
+    static http_echo_server server;
+
+    boost::beast::http::request<boost::beast::http::string_body> request(boost::beast::http::verb::post, "/echo", 11);
+    request.set(boost::beast::http::field::host, server.host());
+    request.body() = std::string(200, 'x');
+    request.prepare_payload();
+
+    stream_client::http::http_client client(server.endpoint(), std::chrono::seconds(1), std::chrono::seconds(5));
+    for (auto _ : state) {
+        const auto response = client.perform(request);
+        benchmark::DoNotOptimize(response);
+    }
+}
+BENCHMARK(BM_HttpPerform);
+
+/// greedy_strategy::refill() latency for various pool sizes.
+static void BM_GreedyRefill(benchmark::State& state)
+{
+    static echo_server server;
+    static stream_client::connector::tcp_connector connector(server.host(), server.port(), std::chrono::seconds(1),
+                                                             std::chrono::seconds(1), std::chrono::seconds(5));
+
+    stream_client::connector::greedy_strategy<stream_client::connector::tcp_connector> strategy;
+
+    const std::size_t vacant_places = state.range(0);
+    for (auto _ : state) {
+        std::mutex sessions_mutex;
+        std::vector<std::unique_ptr<stream_client::tcp_client>> sessions;
+        strategy.refill(connector, vacant_places, [&](std::unique_ptr<stream_client::tcp_client>&& session) {
+            std::lock_guard<std::mutex> lk(sessions_mutex);
+            sessions.emplace_back(std::move(session));
+        });
+        benchmark::DoNotOptimize(sessions);
+    }
+}
+BENCHMARK(BM_GreedyRefill)->Arg(10)->Arg(100)->Unit(benchmark::kMillisecond);
+
+BENCHMARK_MAIN();
@@ -0,0 +1,193 @@
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace stream_client {
+namespace connector {
+
+/**
+ * Shared scheduler for the background maintenance of pools and connectors.
+ *
+ * By default every base_connection_pool spawns a dedicated watcher thread and every
+ * base_connector a dedicated resolving thread, so a process talking to dozens of
+ * upstreams carries twice as many mostly-idle threads, each waking on its own timer.
+ * Pools and connectors constructed with a reference to this scheduler register their
+ * maintenance (idle sweeps, refills, DNS refresh) as timed tasks here instead, so all
+ * of them share the configured number of worker threads.
+ *
+ * A task is a callable performing one maintenance round and returning the time-point
+ * of its next run; time_point_type::max() parks the task until an explicit wake().
+ *
+ * @note Thread-safe. The scheduler must outlive every pool and connector registered
+ *      with it. A long-running task delays others when all workers are busy, which is
+ *      the price of consolidation - size @p concurrency accordingly.
+ */
+class background_scheduler
+{
+public:
+    using clock_type = std::chrono::steady_clock;
+    using time_point_type = clock_type::time_point;
+    using task_type = std::function<time_point_type()>;
+    using task_id_type = std::uint64_t;
+
+    /**
+     * Creates scheduler with @p concurrency worker threads.
+     *
+     * @param[in] concurrency Number of workers to spawn.
+     */
+    explicit background_scheduler(std::size_t concurrency = 1)
+    {
+        workers_.reserve(concurrency);
+        for (std::size_t i = 0; i < concurrency; ++i) {
+            workers_.emplace_back([this]() { worker_loop(); });
+        }
+    }
+
+    /// Copy constructor is not permitted.
+    background_scheduler(const background_scheduler& other) = delete;
+    /// Copy assignment is not permitted.
+    background_scheduler& operator=(const background_scheduler& other) = delete;
+
+    /// Destructor. Stops the workers; registered tasks must have been removed by their owners.
+    ~background_scheduler()
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            stopped_ = true;
+        }
+        tasks_cv_.notify_all();
+        for (auto& worker : workers_) {
+            worker.join();
+        }
+    }
+
+    /**
+     * Register a recurring task; its first round runs as soon as a worker is free.
+     * Due tasks are served in registration order, so dependencies should register first
+     * (e.g. a connector's resolve task before the pool watcher that waits on it).
+     *
+     * @param[in] task Task to run; anything it references must stay valid until remove().
+     *
+     * @returns Identifier to wake() or remove() the task with.
+     */
+    task_id_type add(task_type task)
+    {
+        task_id_type id = 0;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            id = next_id_++;
+            tasks_.emplace(id, task_entry{std::move(task), clock_type::now(), false});
+        }
+        tasks_cv_.notify_one();
+        return id;
+    }
+
+    /**
+     * Run the task as soon as possible, overriding its own schedule.
+     * A wake arriving while the task is mid-run schedules one more round after it.
+     *
+     * @param[in] id Identifier returned by add(). Unknown ids are ignored.
+     */
+    void wake(task_id_type id)
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            auto found = tasks_.find(id);
+            if (found == tasks_.end()) {
+                return;
+            }
+            found->second.next_run = std::min(found->second.next_run, clock_type::now());
+        }
+        tasks_cv_.notify_all();
+    }
+
+    /**
+     * Deregister a task. Blocks until an in-flight round of it has finished,
+     * so upon return the task is guaranteed to never run again.
+     *
+     * @param[in] id Identifier returned by add(). Unknown ids are ignored.
+     */
+    void remove(task_id_type id)
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        idle_cv_.wait(lock, [this, id]() {
+            const auto found = tasks_.find(id);
+            return found == tasks_.end() || !found->second.running;
+        });
+        tasks_.erase(id);
+    }
+
+private:
+    /// Single registered task with its schedule.
+    struct task_entry
+    {
+        task_type task; ///< The maintenance round to run.
+        time_point_type next_run; ///< When to run it next; max() parks it until wake().
+        bool running; ///< Set while a worker executes the task.
+    };
+
+    /// Worker body: run due tasks, sleep until the earliest scheduled one.
+    void worker_loop()
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        while (!stopped_) {
+            time_point_type earliest = time_point_type::max();
+            task_entry* due_task = nullptr;
+            task_id_type due_id = 0;
+            const auto now = clock_type::now();
+            for (auto& item : tasks_) {
+                if (item.second.running) {
+                    continue;
+                }
+                if (item.second.next_run <= now) {
+                    due_task = &item.second;
+                    due_id = item.first;
+                    break;
+                }
+                earliest = std::min(earliest, item.second.next_run);
+            }
+
+            if (due_task == nullptr) {
+                if (earliest == time_point_type::max()) {
+                    tasks_cv_.wait(lock);
+                } else {
+                    tasks_cv_.wait_until(lock, earliest);
+                }
+                continue;
+            }
+
+            // parked while running so a concurrent wake() is not lost below
+            due_task->running = true;
+            due_task->next_run = time_point_type::max();
+            lock.unlock();
+            const auto next_run = due_task->task();
+            lock.lock();
+
+            const auto found = tasks_.find(due_id);
+            if (found != tasks_.end()) {
+                found->second.running = false;
+                // a wake() received mid-run wins over the task's own schedule
+                found->second.next_run = std::min(next_run, found->second.next_run);
+            }
+            idle_cv_.notify_all();
+        }
+    }
+
+    std::mutex mutex_; ///< Protects @p tasks_, @p next_id_ and @p stopped_.
+    std::condition_variable tasks_cv_; ///< Wakes workers on new, woken or stopped tasks.
+    std::condition_variable idle_cv_; ///< Wakes remove() once a running task finishes.
+    std::map<task_id_type, task_entry> tasks_; ///< Registered tasks keyed by id.
+    task_id_type next_id_{1}; ///< Id for the next add().
+    bool stopped_{false}; ///< Set in destructor to terminate workers.
+    std::vector<std::thread> workers_; ///< Worker threads.
+};
+
+} // namespace connector
+} // namespace stream_client
@@ -0,0 +1,137 @@
+#pragma once
+
+#include <algorithm>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace stream_client {
+namespace connector {
+namespace detail {
+
+/**
+ * Persistent executor for pool refill jobs.
+ *
+ * Runs submitted connect jobs on a small fixed set of worker threads, so a
+ * refill round costs queue operations instead of one thread spawn/join per
+ * vacant place. Used by pool strategies, see pool_strategy.hpp.
+ *
+ * @note Thread-safe. Jobs submitted from one thread may run on any worker.
+ */
+class connect_engine
+{
+public:
+    using job_type = std::function<void()>;
+
+    /**
+     * Creates engine with @p concurrency worker threads.
+     *
+     * @param[in] concurrency Number of workers to spawn.
+     */
+    explicit connect_engine(std::size_t concurrency = default_concurrency())
+    {
+        workers_.reserve(concurrency);
+        for (std::size_t i = 0; i < concurrency; ++i) {
+            workers_.emplace_back([this]() { worker_loop(); });
+        }
+    }
+
+    /// Copy constructor is not permitted.
+    connect_engine(const connect_engine& other) = delete;
+    /// Copy assignment is not permitted.
+    connect_engine& operator=(const connect_engine& other) = delete;
+
+    /// Destructor. Waits for running jobs, drops queued ones.
+    ~connect_engine()
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            stopped_ = true;
+        }
+        jobs_cv_.notify_all();
+        for (auto& worker : workers_) {
+            worker.join();
+        }
+    }
+
+    /**
+     * Enqueue a job for execution.
+     * Anything the job references must stay valid until wait() returns.
+     *
+     * @param[in] job Job to run on one of the workers.
+     */
+    void submit(job_type job)
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            jobs_.emplace_back(std::move(job));
+            ++pending_;
+        }
+        jobs_cv_.notify_one();
+    }
+
+    /// Block until all submitted jobs have finished.
+    void wait()
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        done_cv_.wait(lock, [this]() { return pending_ == 0; });
+    }
+
+    /**
+     * Process-wide shared engine.
+     * Used for detached asynchronous operations (async_new_session(), async_perform() and
+     * the like), so they multiplex over one small worker set instead of spawning threads.
+     *
+     * @returns Reference to the lazily-created engine, alive until process exit.
+     */
+    static connect_engine& shared()
+    {
+        static connect_engine instance;
+        return instance;
+    }
+
+    /// Default worker count: hardware concurrency clamped to [2, 8].
+    static std::size_t default_concurrency()
+    {
+        const std::size_t hw_threads = std::thread::hardware_concurrency();
+        return std::max<std::size_t>(2, std::min<std::size_t>(8, hw_threads));
+    }
+
+private:
+    /// Worker body: run queued jobs until stopped.
+    void worker_loop()
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        while (true) {
+            jobs_cv_.wait(lock, [this]() { return stopped_ || !jobs_.empty(); });
+            if (stopped_) {
+                return;
+            }
+
+            job_type job = std::move(jobs_.front());
+            jobs_.pop_front();
+            lock.unlock();
+            job();
+            lock.lock();
+
+            if (--pending_ == 0) {
+                done_cv_.notify_all();
+            }
+        }
+    }
+
+    std::mutex mutex_; ///< Protects jobs_, pending_ and stopped_.
+    std::condition_variable jobs_cv_; ///< Wakes workers on new jobs or stop.
+    std::condition_variable done_cv_; ///< Wakes wait() once all jobs are done.
+    std::deque<job_type> jobs_; ///< Queued jobs.
+    std::size_t pending_{0}; ///< Jobs queued or currently running.
+    bool stopped_{false}; ///< Set in destructor to terminate workers.
+    std::vector<std::thread> workers_; ///< Worker threads.
+};
+
+} // namespace detail
+} // namespace connector
+} // namespace stream_client
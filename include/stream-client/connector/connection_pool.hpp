@@ -1,10 +1,18 @@
 #pragma once
 
 #include "connector.hpp"
+#include "pool_metrics.hpp"
+#include "pool_storage.hpp"
 #include "pool_strategy.hpp"
 
+#include <boost/asio/async_result.hpp>
+
 #include <atomic>
+#include <condition_variable>
+#include <functional>
 #include <list>
+#include <memory>
+#include <mutex>
 
 namespace stream_client {
 namespace connector {
@@ -22,8 +30,10 @@ namespace connector {
  *
  * @tparam Connector Type of connector to use to create sockets.
  * @tparam Strategy Type of reconnection strategy. For more info look in pool_strategy.hpp.
+ * @tparam Storage Type of session storage. For more info look in pool_storage.hpp.
  */
-template <typename Connector, typename Strategy = greedy_strategy<Connector>>
+template <typename Connector, typename Strategy = greedy_strategy<Connector>,
+          typename Storage = list_pool_storage<Connector>>
 class base_connection_pool
 {
 public:
@@ -35,6 +45,29 @@ public:
     using time_duration_type = typename connector_type::time_duration_type;
     using time_point_type = typename connector_type::time_point_type;
 
+    /**
+     * Parametrized constructor.
+     * Constructs pool for desired connector (protocol). Passed @p argn forwarded to @p Connector constructor.
+     * This operation starts background thread to fill the pool with opened sockets,
+     * therefore subsequent get_session() calls may take longer time compared with the state when pool is full.
+     *
+     * @tparam ...ArgN Types of argn.
+     *
+     * @param[in] size Number of connected sockets to maintain in the pool.
+     *      Note that real number of established connections my be @p size + 1.
+     *      This happens when you pull a stream with get_session() , the pool establishes new one to replace it,
+     *      and later you return pulled stream back with return_session().
+     * @param[in] idle_timeout sessions which are in the pool for a longer time are replaced with new ones.
+     * @param[in] reuse_order Order in which pooled sessions are reused, see pool_reuse_order.
+     *      pool_reuse_order::lifo hands out the most-recently-returned (warmest) session first,
+     *      which combined with @p idle_timeout concentrates traffic on a warm subset and lets
+     *      the surplus expire under low load.
+     * @param[in] ...argn Arguments to pass to @p Connector constructor.
+     */
+    template <typename... ArgN>
+    base_connection_pool(std::size_t size, time_duration_type idle_timeout, pool_reuse_order reuse_order,
+                         ArgN&&... argn);
+
     /**
      * Parametrized constructor.
      * Constructs pool for desired connector (protocol). Passed @p argn forwarded to @p Connector constructor.
@@ -53,6 +86,19 @@ public:
     template <typename... ArgN>
     base_connection_pool(std::size_t size, time_duration_type idle_timeout, ArgN&&... argn);
 
+    /**
+     * Parametrized constructor.
+     * Same as above but without idle timeout, sessions are reused in @p reuse_order forever.
+     *
+     * @tparam ...ArgN Types of argn.
+     *
+     * @param[in] size Number of connected sockets to maintain in the pool.
+     * @param[in] reuse_order Order in which pooled sessions are reused, see pool_reuse_order.
+     * @param[in] ...argn Arguments to pass to @p Connector constructor.
+     */
+    template <typename... ArgN>
+    base_connection_pool(std::size_t size, pool_reuse_order reuse_order, ArgN&&... argn);
+
     /**
      * Parametrized constructor.
      * Constructs pool for desired connector (protocol). Passed @p argn forwarded to @p Connector constructor.
@@ -69,9 +115,44 @@ public:
      */
     template <typename Arg1, typename... ArgN,
               typename std::enable_if<
-                  !std::is_convertible<Arg1, typename Connector::time_duration_type>::value>::type* = nullptr>
+                  !std::is_convertible<Arg1, typename Connector::time_duration_type>::value &&
+                  !std::is_same<typename std::decay<Arg1>::type, pool_reuse_order>::value>::type* = nullptr>
     base_connection_pool(std::size_t size, Arg1&& arg1, ArgN&&... argn);
 
+    /**
+     * Parametrized constructor with shared scheduler.
+     * Same as the default one, but pool maintenance (idle sweeps, refills, liveness
+     * screening) and the underlying connector's DNS refresh run as timed tasks on
+     * @p scheduler instead of two dedicated threads, so pools to many upstreams share
+     * the scheduler's worker set. The scheduler must outlive the pool.
+     *
+     * @tparam ...ArgN Types of argn.
+     *
+     * @param[in] scheduler Shared scheduler to run the maintenance on.
+     * @param[in] size Number of connected sockets to maintain in the pool.
+     * @param[in] idle_timeout sessions which are in the pool for a longer time are replaced with new ones.
+     * @param[in] reuse_order Order in which pooled sessions are reused, see pool_reuse_order.
+     * @param[in] ...argn Arguments to pass to @p Connector constructor.
+     */
+    template <typename... ArgN>
+    base_connection_pool(background_scheduler& scheduler, std::size_t size, time_duration_type idle_timeout,
+                         pool_reuse_order reuse_order, ArgN&&... argn);
+
+    /**
+     * Parametrized constructor with shared scheduler.
+     * Same as above but with default (fifo) reuse order.
+     *
+     * @tparam ...ArgN Types of argn.
+     *
+     * @param[in] scheduler Shared scheduler to run the maintenance on.
+     * @param[in] size Number of connected sockets to maintain in the pool.
+     * @param[in] idle_timeout sessions which are in the pool for a longer time are replaced with new ones.
+     * @param[in] ...argn Arguments to pass to @p Connector constructor.
+     */
+    template <typename... ArgN>
+    base_connection_pool(background_scheduler& scheduler, std::size_t size, time_duration_type idle_timeout,
+                         ArgN&&... argn);
+
     /// Copy constructor is not permitted.
     base_connection_pool(const base_connection_pool<Connector>& other) = delete;
     /// Copy assignment is not permitted.
@@ -89,8 +170,10 @@ public:
      * Tries to get stream from the pool until specified deadline is reached.
      *
      * @note Since returned stream was established prior to this call, there is no guarantee it's still
-     *      valid to send or receive data. It may be closed on server-side because of inactivity or anything else.
-     *      It this case you may retry to get_session() until you get valid one.
+     *      valid to send or receive data. Sessions are cheaply screened at hand-out (non-blocking peek
+     *      on the native handle), so a peer-closed one is dropped and replaced instead of being returned;
+     *      still the peer may close it right after the screening, in this case you may retry to
+     *      get_session() until you get valid one.
      *
      * @param[in] deadline Expiration time-point.
      * @param[out] ec Set to indicate what error occurred, if any.
@@ -104,8 +187,10 @@ public:
      * Tries to get stream from the pool until specified timeout elapsed.
      *
      * @note Since returned stream was established prior to this call, there is no guarantee it's still
-     *      valid to send or receive data. It may be closed on server-side because of inactivity or anything else.
-     *      It this case you may retry to get_session() until you get valid one.
+     *      valid to send or receive data. Sessions are cheaply screened at hand-out (non-blocking peek
+     *      on the native handle), so a peer-closed one is dropped and replaced instead of being returned;
+     *      still the peer may close it right after the screening, in this case you may retry to
+     *      get_session() until you get valid one.
      *
      * @param[in] timeout Expiration duration.
      * @param[out] ec Set to indicate what error occurred, if any.
@@ -123,8 +208,10 @@ public:
      * default connection timeout (returned by get_connect_timeout).
      *
      * @note Since returned stream was established prior to this call, there is no guarantee it's still
-     *      valid to send or receive data. It may be closed on server-side because of inactivity or anything else.
-     *      It this case you may retry to get_session() until you get valid one.
+     *      valid to send or receive data. Sessions are cheaply screened at hand-out (non-blocking peek
+     *      on the native handle), so a peer-closed one is dropped and replaced instead of being returned;
+     *      still the peer may close it right after the screening, in this case you may retry to
+     *      get_session() until you get valid one.
      *
      * @param[out] ec Set to indicate what error occurred, if any.
      *
@@ -141,8 +228,10 @@ public:
      * default connection timeout (returned by get_connect_timeout).
      *
      * @note Since returned stream was established prior to this call, there is no guarantee it's still
-     *      valid to send or receive data. It may be closed on server-side because of inactivity or anything else.
-     *      It this case you may retry to get_session() until you get valid one.
+     *      valid to send or receive data. Sessions are cheaply screened at hand-out (non-blocking peek
+     *      on the native handle), so a peer-closed one is dropped and replaced instead of being returned;
+     *      still the peer may close it right after the screening, in this case you may retry to
+     *      get_session() until you get valid one.
      *
      * @param[in] timeout_or_deadline Expiration time-point or duration.
      *
@@ -172,8 +261,10 @@ public:
      * default connection timeout (returned by get_connect_timeout).
      *
      * @note Since returned stream was established prior to this call, there is no guarantee it's still
-     *      valid to send or receive data. It may be closed on server-side because of inactivity or anything else.
-     *      It this case you may retry to get_session() until you get valid one.
+     *      valid to send or receive data. Sessions are cheaply screened at hand-out (non-blocking peek
+     *      on the native handle), so a peer-closed one is dropped and replaced instead of being returned;
+     *      still the peer may close it right after the screening, in this case you may retry to
+     *      get_session() until you get valid one.
      *
      * @returns A stream wrapped in std::unique_ptr. Guaranteed to return valid pointer.
      * @throws boost::system::system_error Thrown on failure.
@@ -213,6 +304,50 @@ public:
         return try_get_session(ec, clock_type::now() + timeout);
     }
 
+    /**
+     * Pull a session (stream) from the pool asynchronously.
+     * Completes at once if a session is available; otherwise the handler is queued and fed
+     * the next session that is returned or established - no thread blocks while waiting.
+     * Waiters that are not served within the default connect timeout (get_connect_timeout())
+     * complete with boost::asio::error::timed_out.
+     *
+     * @note The completion handler may be invoked on a pool-internal thread or on the thread
+     *      returning a session, with signature
+     *      void(boost::system::error_code, std::unique_ptr<stream_type>). @p token may be a
+     *      plain callback or any asio completion token, e.g. boost::asio::use_future.
+     *
+     * @param[in] token Completion token deciding how the result is delivered.
+     */
+    template <typename CompletionToken>
+    auto async_get_session(CompletionToken&& token)
+    {
+        return boost::asio::async_initiate<CompletionToken,
+                                           void(boost::system::error_code, std::unique_ptr<stream_type>)>(
+            [this](auto&& handler) {
+                boost::system::error_code ec;
+                auto session = try_get_session(ec, clock_type::now());
+                if (session) {
+                    handler(boost::system::error_code(), std::move(session));
+                    return;
+                }
+
+                using handler_type = typename std::decay<decltype(handler)>::type;
+                auto handler_ptr = std::make_shared<handler_type>(std::forward<decltype(handler)>(handler));
+                const auto now = clock_type::now();
+                {
+                    std::lock_guard<std::mutex> lk(waiters_mutex_);
+                    session_waiters_.push_back(
+                        session_waiter{now, now + get_connect_timeout(),
+                                       [handler_ptr](boost::system::error_code waiter_ec,
+                                                     std::unique_ptr<stream_type>&& waiter_session) {
+                                           (*handler_ptr)(waiter_ec, std::move(waiter_session));
+                                       }});
+                }
+                notify_watcher();
+            },
+            token);
+    }
+
     /**
      * Return the session pulled earlier from the pool.
      *
@@ -223,6 +358,73 @@ public:
      */
     void return_session(std::unique_ptr<stream_type>&& session);
 
+    /**
+     * Fill the pool to its configured size with maximum connect parallelism.
+     * Intended for service startup: the background watcher refills at the pace of the
+     * configured strategy, while this method connects every vacant place simultaneously
+     * and returns once the pool is full, so the first requests hit warm sessions instead
+     * of paying connect latency. Sessions established here land in the pool as usual.
+     *
+     * @param[out] ec Set to boost::asio::error::timed_out if the pool is still not full past the deadline.
+     * @param[in] deadline Expiration time-point.
+     *
+     * @returns true - if the pool holds pool size of sessions; false otherwise.
+     */
+    bool warm_up(boost::system::error_code& ec, const time_point_type& deadline);
+
+    /**
+     * Fill the pool to its configured size with maximum connect parallelism.
+     * Same as above but bounded with timeout instead of deadline.
+     *
+     * @param[out] ec Set to boost::asio::error::timed_out if the pool is still not full past the timeout.
+     * @param[in] timeout Expiration duration.
+     *
+     * @returns true - if the pool holds pool size of sessions; false otherwise.
+     */
+    inline bool warm_up(boost::system::error_code& ec, const time_duration_type& timeout)
+    {
+        return warm_up(ec, clock_type::now() + timeout);
+    }
+
+    /**
+     * Block until the pool holds at least @p fraction of its configured size.
+     * Unlike is_connected(), which only reports a non-empty pool, this lets the caller
+     * gate readiness on an arbitrary fill level (e.g. 0.8 of the pool before taking traffic).
+     *
+     * @param[in] fraction Required fill level relative to the pool size, clamped to [0.0, 1.0].
+     * @param[out] ec Set to boost::asio::error::timed_out if the level is not reached before the deadline.
+     * @param[in] deadline Expiration time-point.
+     *
+     * @returns true - if the pool reached the requested level; false otherwise.
+     */
+    bool wait_ready(double fraction, boost::system::error_code& ec, const time_point_type& deadline) const;
+
+    /**
+     * Block until the pool holds at least @p fraction of its configured size.
+     * Same as above but bounded with timeout instead of deadline.
+     *
+     * @param[in] fraction Required fill level relative to the pool size, clamped to [0.0, 1.0].
+     * @param[out] ec Set to boost::asio::error::timed_out if the level is not reached before the timeout.
+     * @param[in] timeout Expiration duration.
+     *
+     * @returns true - if the pool reached the requested level; false otherwise.
+     */
+    inline bool wait_ready(double fraction, boost::system::error_code& ec, const time_duration_type& timeout) const
+    {
+        return wait_ready(fraction, ec, clock_type::now() + timeout);
+    }
+
+    /**
+     * Number of sessions currently stored in the pool.
+     * Approximate: concurrent pulls, returns and refills move it at any time.
+     *
+     * @returns Current number of stored sessions.
+     */
+    inline std::size_t current_size() const
+    {
+        return sesson_pool_.size();
+    }
+
     /**
      * Check if pool has at least one stream.
      * Waits until @p deadline for pool to become non-empty.
@@ -310,45 +512,114 @@ public:
         return connector_.get_operation_timeout();
     }
 
+    /**
+     * Get hot-path counters of this pool (acquire waits, hits/misses, refills, evictions).
+     * Use pool_metrics::snapshot() on the result to scrape them.
+     *
+     * @returns A const reference to the live counters.
+     */
+    inline const pool_metrics& get_metrics() const
+    {
+        return metrics_;
+    }
+
+    /**
+     * Get connect/resolve counters of the underlying connector.
+     * Use connector_metrics::snapshot() on the result to scrape them.
+     *
+     * @returns A const reference to the live counters.
+     */
+    inline const connector_metrics& get_connector_metrics() const
+    {
+        return connector_.get_metrics();
+    }
+
 private:
+    /// Handler queued by async_get_session() waiting for a session to become available.
+    struct session_waiter
+    {
+        time_point_type started; ///< When the wait began, used for metrics.
+        time_point_type deadline; ///< Completes with timed_out past this point.
+        std::function<void(boost::system::error_code, std::unique_ptr<stream_type>&&)> handler; ///< Completion handler.
+    };
+
     /// Background routine used to maintain the pool.
     void watch_pool_routine();
 
+    /// One maintenance round of watch_pool_routine(): idle sweep, screening, waiter expiry
+    /// and refill. Also runs as a background_scheduler task in consolidated mode.
+    /// @returns when to run it next; time_point_type::max() means wait for an explicit wake.
+    time_point_type watch_pool_step();
+
+    /// Wake the watcher up, e.g. after a pull made room for a new session.
+    inline void notify_watcher()
+    {
+        if (scheduler_ != nullptr) {
+            scheduler_->wake(watch_task_);
+            return;
+        }
+        {
+            std::lock_guard<std::mutex> lk(watch_mutex_);
+            watch_signal_ = true;
+        }
+        watch_cv_.notify_one();
+    }
+
     std::string name_; ///< Name pf the pool.
     Strategy reconnection_; ///< Instance of reconnection strategy used to fill the pool.
     connector_type connector_; ///< Underlying connector used to establish sockets.
 
     std::size_t pool_max_size_; ///< Number of stream to keep in the @p sesson_pool_.
     time_duration_type idle_timeout_; ///< Idle timeout for the sessions in the @p sesson_pool_.
-    std::list<std::pair<time_point_type, std::unique_ptr<stream_type>>>
-        sesson_pool_; ///< The list of established sockets.
-    mutable std::timed_mutex pool_mutex_; ///< @p sesson_pool_ mutex.
-    mutable std::condition_variable_any pool_cv_; ///< @p sesson_pool_ condition variable.
+    Storage sesson_pool_; ///< Storage of established sockets.
 
     std::atomic_bool watch_pool_{false}; ///< Flag to stop @p pool_watcher_.
     std::thread pool_watcher_; ///< Thread to run watch_pool_routine() in.
+    background_scheduler* scheduler_{nullptr}; ///< Shared scheduler; nullptr when @p pool_watcher_ is used.
+    background_scheduler::task_id_type watch_task_{0}; ///< Maintenance task registered on @p scheduler_.
+    time_point_type next_screening_{}; ///< When the next liveness screening of stored sessions is due.
+    mutable std::mutex watch_mutex_; ///< Guards @p watch_signal_.
+    std::condition_variable watch_cv_; ///< Wakes the watcher up on demand, see notify_watcher().
+    bool watch_signal_{false}; ///< Set when the watcher has been explicitly woken up.
+
+    std::list<session_waiter> session_waiters_; ///< Handlers waiting for a session, see async_get_session().
+    std::mutex waiters_mutex_; ///< Guards @p session_waiters_.
 
-    bool ensure_session(std::unique_lock<std::timed_mutex>& pool_lk, boost::system::error_code& ec,
-                        const time_point_type& deadline) const;
+    pool_metrics metrics_; ///< Hot-path counters, see get_metrics().
 };
 
 //! Connections pool with sockets over plain TCP protocol.
 using tcp_pool = base_connection_pool<tcp_connector>;
 using tcp_conservative_pool = base_connection_pool<tcp_connector, conservative_strategy<tcp_connector>>;
+using tcp_adaptive_pool = base_connection_pool<tcp_connector, adaptive_strategy<tcp_connector>>;
+using tcp_lockfree_pool = base_connection_pool<tcp_connector, greedy_strategy<tcp_connector>,
+                                               mpmc_pool_storage<tcp_connector>>;
 //! Connections pool with sockets over plain UDP protocol.
 using udp_pool = base_connection_pool<udp_connector>;
 using udp_conservative_pool = base_connection_pool<udp_connector, conservative_strategy<udp_connector>>;
+using udp_adaptive_pool = base_connection_pool<udp_connector, adaptive_strategy<udp_connector>>;
+using udp_lockfree_pool = base_connection_pool<udp_connector, greedy_strategy<udp_connector>,
+                                               mpmc_pool_storage<udp_connector>>;
 
 //! Connections pool with sockets over encrypted TCP protocol.
 using ssl_pool = base_connection_pool<ssl_connector>;
 using ssl_conservative_pool = base_connection_pool<ssl_connector, conservative_strategy<ssl_connector>>;
+using ssl_adaptive_pool = base_connection_pool<ssl_connector, adaptive_strategy<ssl_connector>>;
+using ssl_lockfree_pool = base_connection_pool<ssl_connector, greedy_strategy<ssl_connector>,
+                                               mpmc_pool_storage<ssl_connector>>;
 
 //! Connections pool with sockets over HTTP protocol.
 using http_pool = base_connection_pool<http_connector>;
 using http_conservative_pool = base_connection_pool<http_connector, conservative_strategy<http_connector>>;
+using http_adaptive_pool = base_connection_pool<http_connector, adaptive_strategy<http_connector>>;
+using http_lockfree_pool = base_connection_pool<http_connector, greedy_strategy<http_connector>,
+                                                mpmc_pool_storage<http_connector>>;
 //! Connections pool with sockets over HTTPS protocol.
 using https_pool = base_connection_pool<https_connector>;
 using https_conservative_pool = base_connection_pool<https_connector, conservative_strategy<https_connector>>;
+using https_adaptive_pool = base_connection_pool<https_connector, adaptive_strategy<https_connector>>;
+using https_lockfree_pool = base_connection_pool<https_connector, greedy_strategy<https_connector>,
+                                                 mpmc_pool_storage<https_connector>>;
 
 } // namespace connector
 } // namespace stream_client
@@ -1,10 +1,18 @@
 #pragma once
 
+#include "background_scheduler.hpp"
+#include "connect_engine.hpp"
+#include "pool_metrics.hpp"
 #include "stream-client/resolver/resolver.hpp"
 #include "stream-client/stream/http_socket.hpp"
 
+#include <boost/asio/async_result.hpp>
+
 #include <atomic>
 #include <condition_variable>
+#include <list>
+#include <map>
+#include <memory>
 #include <mutex>
 
 namespace stream_client {
@@ -14,7 +22,10 @@ namespace connector {
  * Connector class to obtain new streams (sessions) to desired remote endpoint.
  *
  * This class incorporates stream_client::resolver::base_resolver to provide DNS updates.
- * Address to connect will be chosen randomly if DNS resolved into multiple records.
+ * If DNS resolves into multiple records, the address to connect is chosen by weighted
+ * random choice favoring endpoints with low smoothed connect latency and failure rate;
+ * every kExploreEvery-th connect falls back to plain rotation so slow or recovered
+ * endpoints get re-tried.
  *
  * @note Thread-safe. Single instance support concurrent operation.
  *
@@ -37,6 +48,28 @@ public:
     using time_duration_type = typename stream_type::time_duration_type;
     using time_point_type = typename stream_type::time_point_type;
 
+    /// Default number of endpoints raced by new_session() when racing is enabled.
+    static const std::size_t kDefaultRaceCandidates;
+    /// Default delay between staggered racing connect attempts in ms.
+    static const unsigned long kDefaultRaceDelayMs;
+    /// Default endpoints freshness period in ms; snapshot is re-resolved in background once it expires.
+    static const unsigned long kDefaultEndpointsTTLMs;
+    /// EWMA smoothing factor for per-endpoint connect statistics.
+    static const double kStatsSmoothing;
+    /// Every Nth connect ignores the weights so slow or recovered endpoints get re-tried.
+    static const std::size_t kExploreEvery;
+
+    /**
+     * Per-endpoint connect statistics, see get_endpoint_stats().
+     * Values are exponentially-weighted moving averages over connect attempts.
+     */
+    struct endpoint_stats
+    {
+        double latency_ns{0.0}; ///< Smoothed latency of successful connects, in nanoseconds.
+        double failure_rate{0.0}; ///< Smoothed share of failed attempts, in [0, 1].
+        bool connected{false}; ///< Whether the endpoint succeeded at least once.
+    };
+
     /**
      * Parametrized constructor.
      * Creates connector with desired settings.
@@ -50,11 +83,59 @@ public:
      * @param[in] operation_timeout Timeout for I/O operations on established sessions.
      * @param[in] ip_family Family of IP protocol to resolve (ipv4, ipv6 or any).
      * @param[in] resolve_flags A set of flags that determine how name resolution should be performed.
+     * @param[in] profile Kernel tuning knobs applied on new sessions between socket open and connect.
      */
     base_connector(const std::string& host, const std::string& port, time_duration_type resolve_timeout,
                    time_duration_type connect_timeout, time_duration_type operation_timeout,
                    ::stream_client::resolver::ip_family ip_family = resolver_type::kDefaultIPFamily,
-                   resolve_flags_type resolve_flags = resolver_type::kDefaultFlags);
+                   resolve_flags_type resolve_flags = resolver_type::kDefaultFlags,
+                   ::stream_client::socket_profile profile = ::stream_client::socket_profile());
+
+    /**
+     * Parametrized constructor with shared reactor.
+     * Same as the default one, but sessions spawned via new_session() are multiplexed
+     * onto @p io_reactor instead of allocating io_service per socket. The reactor must
+     * outlive the connector and all sessions it has created.
+     *
+     * @param[in] io_reactor Shared reactor to run sessions on.
+     * @param[in] host Remote hostname.
+     * @param[in] port Remote port.
+     * @param[in] resolve_timeout DNS resolve timeout, used by internal resolve_routine().
+     * @param[in] connect_timeout Default timeout for connecting operation, used by new_session().
+     * @param[in] operation_timeout Timeout for I/O operations on established sessions.
+     * @param[in] ip_family Family of IP protocol to resolve (ipv4, ipv6 or any).
+     * @param[in] resolve_flags A set of flags that determine how name resolution should be performed.
+     * @param[in] profile Kernel tuning knobs applied on new sessions between socket open and connect.
+     */
+    base_connector(::stream_client::reactor& io_reactor, const std::string& host, const std::string& port,
+                   time_duration_type resolve_timeout, time_duration_type connect_timeout,
+                   time_duration_type operation_timeout,
+                   ::stream_client::resolver::ip_family ip_family = resolver_type::kDefaultIPFamily,
+                   resolve_flags_type resolve_flags = resolver_type::kDefaultFlags,
+                   ::stream_client::socket_profile profile = ::stream_client::socket_profile());
+
+    /**
+     * Parametrized constructor with shared scheduler.
+     * Same as the default one, but the background DNS refresh runs as a timed task on
+     * @p scheduler instead of a dedicated resolving thread, so connectors to many
+     * upstreams share a small worker set. The scheduler must outlive the connector.
+     *
+     * @param[in] scheduler Shared scheduler to run the DNS refresh on.
+     * @param[in] host Remote hostname.
+     * @param[in] port Remote port.
+     * @param[in] resolve_timeout DNS resolve timeout, used by internal resolve_step().
+     * @param[in] connect_timeout Default timeout for connecting operation, used by new_session().
+     * @param[in] operation_timeout Timeout for I/O operations on established sessions.
+     * @param[in] ip_family Family of IP protocol to resolve (ipv4, ipv6 or any).
+     * @param[in] resolve_flags A set of flags that determine how name resolution should be performed.
+     * @param[in] profile Kernel tuning knobs applied on new sessions between socket open and connect.
+     */
+    base_connector(background_scheduler& scheduler, const std::string& host, const std::string& port,
+                   time_duration_type resolve_timeout, time_duration_type connect_timeout,
+                   time_duration_type operation_timeout,
+                   ::stream_client::resolver::ip_family ip_family = resolver_type::kDefaultIPFamily,
+                   resolve_flags_type resolve_flags = resolver_type::kDefaultFlags,
+                   ::stream_client::socket_profile profile = ::stream_client::socket_profile());
 
     /// Copy constructor is not permitted.
     base_connector(const base_connector<Stream>& other) = delete;
@@ -143,6 +224,35 @@ public:
         return session;
     }
 
+    /**
+     * Establish new session asynchronously.
+     * Initiates the connect on the process-wide worker engine and returns immediately;
+     * the caller's thread never blocks. Default connect timeout applies.
+     *
+     * @note The completion handler is invoked on a worker thread with signature
+     *      void(boost::system::error_code, std::unique_ptr<stream_type>). @p token may be
+     *      a plain callback or any asio completion token, e.g. boost::asio::use_future.
+     *      The connector must outlive the operation.
+     *
+     * @param[in] token Completion token deciding how the result is delivered.
+     */
+    template <typename CompletionToken>
+    auto async_new_session(CompletionToken&& token)
+    {
+        return boost::asio::async_initiate<CompletionToken,
+                                           void(boost::system::error_code, std::unique_ptr<stream_type>)>(
+            [this](auto&& handler) {
+                using handler_type = typename std::decay<decltype(handler)>::type;
+                auto handler_ptr = std::make_shared<handler_type>(std::forward<decltype(handler)>(handler));
+                detail::connect_engine::shared().submit([this, handler_ptr]() {
+                    boost::system::error_code ec;
+                    auto session = this->new_session(ec);
+                    (*handler_ptr)(ec, std::move(session));
+                });
+            },
+            token);
+    }
+
     /**
      * Get remote hostname.
      *
@@ -206,32 +316,132 @@ public:
         return operation_timeout_;
     }
 
+    /**
+     * Configure racing (happy-eyeballs) connects for new_session().
+     * With @p candidates >= 2, new_session() starts connect attempts to up to @p candidates
+     * shuffled endpoints staggered by @p stagger_delay and hands out the first one to
+     * succeed; late attempts are closed upon completion. With @p candidates <= 1 (default)
+     * endpoints are tried sequentially.
+     *
+     * @param[in] candidates Maximum number of endpoints to race.
+     * @param[in] stagger_delay Delay before each subsequent attempt is started.
+     */
+    inline void set_connect_race(std::size_t candidates, const time_duration_type& stagger_delay)
+    {
+        std::unique_lock<std::mutex> lk(race_config_mutex_);
+        race_candidates_ = candidates;
+        race_stagger_delay_ = stagger_delay;
+    }
+
+    /// Alias to set_connect_race() using default stagger delay.
+    inline void set_connect_race(std::size_t candidates = kDefaultRaceCandidates)
+    {
+        set_connect_race(candidates, std::chrono::milliseconds(kDefaultRaceDelayMs));
+    }
+
+    /**
+     * Get number of endpoints raced by new_session().
+     *
+     * @returns Configured number of candidates; 1 means sequential connects.
+     */
+    inline std::size_t get_connect_race_candidates() const
+    {
+        std::unique_lock<std::mutex> lk(race_config_mutex_);
+        return race_candidates_;
+    }
+
+    /**
+     * Get connect/resolve counters of this connector.
+     * Use connector_metrics::snapshot() on the result to scrape them.
+     *
+     * @returns A const reference to the live counters.
+     */
+    inline const connector_metrics& get_metrics() const
+    {
+        return metrics_;
+    }
+
+    /**
+     * Get connect statistics of a single endpoint.
+     * new_session() uses these to steer new connections toward fast healthy replicas.
+     *
+     * @param[in] peer_endpoint Endpoint to look up.
+     *
+     * @returns Stats wrapped in boost::optional or boost::none if the endpoint was never tried.
+     */
+    inline boost::optional<endpoint_stats> get_endpoint_stats(const endpoint_type& peer_endpoint) const
+    {
+        std::lock_guard<std::mutex> stats_lk(endpoint_stats_mutex_);
+        const auto stats_it = endpoint_stats_.find(peer_endpoint);
+        if (stats_it == endpoint_stats_.end()) {
+            return boost::none;
+        }
+        return stats_it->second;
+    }
+
+    /**
+     * Set the socket tuning profile for subsequently created sessions.
+     * Existing sessions keep the profile they were connected with; hand them back
+     * to the pool and let it refill to roll the new knobs out.
+     *
+     * @param[in] profile Kernel tuning knobs applied between socket open and connect.
+     */
+    inline void set_socket_profile(const ::stream_client::socket_profile& profile)
+    {
+        std::lock_guard<std::mutex> profile_lk(socket_profile_mutex_);
+        socket_profile_ = profile;
+    }
+
+    /// Get the socket tuning profile applied to new sessions, see set_socket_profile().
+    inline ::stream_client::socket_profile get_socket_profile() const
+    {
+        std::lock_guard<std::mutex> profile_lk(socket_profile_mutex_);
+        return socket_profile_;
+    }
+
+    /**
+     * Set endpoints time-to-live.
+     * Once @p ttl has passed since the last resolve, the background thread refreshes
+     * the endpoint snapshot proactively, so connects never pay resolution latency in-band.
+     *
+     * @param[in] ttl New freshness period.
+     */
+    inline void set_endpoints_ttl(const time_duration_type& ttl)
+    {
+        const auto ttl_ms = std::chrono::duration_cast<std::chrono::milliseconds>(ttl).count();
+        endpoints_ttl_ms_.store(ttl_ms > 0 ? ttl_ms : 0, std::memory_order_relaxed);
+    }
+
 protected:
     /// Try to connect to selected endpoint until deadline is not met.
     virtual std::unique_ptr<stream_type> connect_until(const endpoint_type& peer_endpoint,
                                                        const time_point_type& until_time) const;
 
+    /// Race staggered connect attempts to first @p candidates of @p endpoints, returning the winner.
+    std::unique_ptr<stream_type> race_connect(const endpoint_container_type& endpoints, std::size_t candidates,
+                                              const time_duration_type& stagger_delay, boost::system::error_code& ec,
+                                              const time_point_type& deadline);
+
+    /// Shared reactor sessions are multiplexed on; nullptr if sessions own their io_service.
+    inline ::stream_client::reactor* get_reactor() const
+    {
+        return reactor_;
+    }
+
     /// Background routine used to obtain and update remote endpoints.
     void resolve_routine();
 
-    /// Thread-safe setter for @p endpoints_.
-    inline void update_endpoints(resolver_endpoint_iterator_type&& resolved_endpoints)
-    {
-        endpoint_container_type new_endpoints;
-        while (resolved_endpoints != resolver_endpoint_iterator_type()) {
-            new_endpoints.emplace_back(std::move(*resolved_endpoints));
-            ++resolved_endpoints;
-        }
+    /// One round of resolve_routine(): re-resolve if triggered or expired. Also runs as
+    /// a background_scheduler task in consolidated mode. @returns when to run it next.
+    time_point_type resolve_step();
 
-        std::unique_lock<std::mutex> lk(endpoints_mutex_);
-        endpoints_ = std::move(new_endpoints);
-    }
+    /// Lock-free setter for @p endpoints_; publishes a new immutable pre-shuffled snapshot.
+    void update_endpoints(resolver_endpoint_iterator_type&& resolved_endpoints);
 
-    /// Thread-safe getter for @p endpoints_.
-    inline endpoint_container_type get_endpoints()
+    /// Lock-free getter for @p endpoints_; a single atomic load of the current snapshot.
+    inline std::shared_ptr<const endpoint_container_type> get_endpoints() const
     {
-        std::unique_lock<std::mutex> lk(endpoints_mutex_);
-        return endpoints_;
+        return std::atomic_load(&endpoints_);
     }
 
     /// Thread-safe setter for @p resolve_error_.
@@ -255,6 +465,9 @@ protected:
         resolve_needed_ = true;
         resolve_needed_lk.unlock();
         resolve_needed_cv_.notify_all();
+        if (scheduler_ != nullptr) {
+            scheduler_->wake(resolve_task_);
+        }
     }
 
     /// Notify from resolve_routine() that @p endpoints_ updated.
@@ -267,19 +480,34 @@ protected:
     }
 
 private:
+    /// Delegation target of the public constructors; spawns the resolving thread or
+    /// registers the resolve task on @p scheduler when one is supplied.
+    base_connector(background_scheduler* scheduler, const std::string& host, const std::string& port,
+                   time_duration_type resolve_timeout, time_duration_type connect_timeout,
+                   time_duration_type operation_timeout, ::stream_client::resolver::ip_family ip_family,
+                   resolve_flags_type resolve_flags, ::stream_client::socket_profile profile);
+
     const std::string host_; ///< Remote host.
     const std::string port_; ///< Remote port.
     const time_duration_type resolve_timeout_; ///< Resolve timeout value used in resolve_routine().
     const time_duration_type connect_timeout_; ///< Timeout for connecting operation, used by new_session().
     const time_duration_type operation_timeout_; ///< Timeout for I/O operations on established sessions.
 
+    ::stream_client::reactor* reactor_{nullptr}; ///< Optional shared reactor for spawned sessions.
+
     resolver_type resolver_; ///< Underlying resolver.
 
-    endpoint_container_type endpoints_; ///< Resolved endpoints.
-    mutable std::mutex endpoints_mutex_; ///< @p endpoints_ mutex.
+    /// Immutable snapshot of resolved endpoints, swapped atomically on re-resolve.
+    std::shared_ptr<const endpoint_container_type> endpoints_{std::make_shared<endpoint_container_type>()};
+    std::atomic<std::size_t> endpoint_rotation_{0}; ///< Rotating start index over the pre-shuffled snapshot.
+    std::atomic<long long> endpoints_ttl_ms_{static_cast<long long>(kDefaultEndpointsTTLMs)}; ///< Endpoints freshness
+                                                                                             ///< period.
+    time_point_type next_refresh_{time_point_type::max()}; ///< When the snapshot expires; resolve thread only.
 
     std::atomic_bool resolving_thread_running_{true}; ///< Flag to stop @p resolving_thread_.
     std::thread resolving_thread_; ///< Thread to run resolve_routine() in.
+    background_scheduler* scheduler_{nullptr}; ///< Shared scheduler; nullptr when @p resolving_thread_ is used.
+    background_scheduler::task_id_type resolve_task_{0}; ///< Resolve task registered on @p scheduler_.
 
     boost::system::error_code resolve_error_; ///< Error value propagated from @p resolving_thread_.
     mutable std::mutex resolve_error_mutex_; ///< @p resolve_error_ mutex.
@@ -291,6 +519,32 @@ private:
     bool resolve_done_{false}; ///< Flag to notify that @p resolving_thread_ has done @p endpoints_ update.
     std::timed_mutex resolve_done_mutex_; ///< @p resolve_done_ mutex.
     std::condition_variable_any resolve_done_cv_; ///< @p resolve_done_ condition variable.
+
+    /// Track a racing attempt thread, reaping already finished ones.
+    void add_race_thread(std::thread&& attempt_thread, std::shared_ptr<std::atomic_bool> done_flag);
+
+    /// Record the outcome of a connect attempt against @p peer_endpoint for weighted selection.
+    void record_endpoint_result(const endpoint_type& peer_endpoint, bool success, std::uint64_t latency_ns);
+
+    /// Order of endpoint indices for the next connect: weighted random choice favoring fast
+    /// and healthy endpoints, degrading to plain rotation every kExploreEvery-th call.
+    std::vector<std::size_t> pick_endpoints(const endpoint_container_type& endpoints, std::size_t start) const;
+
+    std::map<endpoint_type, endpoint_stats> endpoint_stats_; ///< Connect statistics keyed by endpoint.
+    mutable std::mutex endpoint_stats_mutex_; ///< @p endpoint_stats_ mutex.
+
+    ::stream_client::socket_profile socket_profile_; ///< Kernel tuning knobs for new sessions.
+    mutable std::mutex socket_profile_mutex_; ///< @p socket_profile_ mutex.
+
+    std::size_t race_candidates_{1}; ///< Number of endpoints new_session() races; 1 means sequential.
+    time_duration_type race_stagger_delay_{}; ///< Delay between staggered racing attempts.
+    mutable std::mutex race_config_mutex_; ///< Protects racing configuration.
+
+    /// Racing attempt threads with their completion flags; losers finish in background.
+    std::list<std::pair<std::thread, std::shared_ptr<std::atomic_bool>>> race_threads_;
+    std::mutex race_threads_mutex_; ///< @p race_threads_ mutex.
+
+    connector_metrics metrics_; ///< Connect/resolve counters, see get_metrics().
 };
 
 //! Connector for plain TCP protocol.
@@ -1,164 +1,416 @@
 #pragma once
 
 #include "stream-client/logger.hpp"
+#include "stream-client/tracer.hpp"
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <cerrno>
+#include <sys/socket.h>
+#endif
+
+#include <cmath>
+#include <thread>
 
 namespace stream_client {
 namespace connector {
+namespace detail {
+
+/**
+ * Cheap liveness screening of a pooled session.
+ * Non-blocking MSG_PEEK on the native handle: a peer-closed socket shows up as
+ * a zero-byte read or a pending error in microseconds, real data is left intact.
+ * On platforms without such peek only the open flag is checked.
+ *
+ * @returns false if the peer has closed the connection or an error is pending on the socket.
+ */
+template <typename Session>
+inline bool session_alive(Session& session)
+{
+#if defined(__unix__) || defined(__APPLE__)
+    if (!session.is_open()) {
+        return false;
+    }
+    char probe = 0;
+    const ssize_t peeked = ::recv(session.lowest_layer().native_handle(), &probe, 1, MSG_PEEK | MSG_DONTWAIT);
+    if (peeked == 0) {
+        // orderly shutdown by the peer
+        return false;
+    }
+    if (peeked < 0 && errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR) {
+        // pending socket error, e.g. ECONNRESET
+        return false;
+    }
+    return true;
+#else
+    return session.is_open();
+#endif
+}
+
+} // namespace detail
 
-template <typename Connector, typename Strategy>
+template <typename Connector, typename Strategy, typename Storage>
 template <typename... ArgN>
-base_connection_pool<Connector, Strategy>::base_connection_pool(std::size_t size, time_duration_type idle_timeout,
-                                                                ArgN&&... argn)
+base_connection_pool<Connector, Strategy, Storage>::base_connection_pool(std::size_t size,
+                                                                         time_duration_type idle_timeout,
+                                                                         pool_reuse_order reuse_order, ArgN&&... argn)
     : connector_(std::forward<ArgN>(argn)...)
     , pool_max_size_(size)
     , idle_timeout_(idle_timeout)
+    , sesson_pool_(size, reuse_order)
     , watch_pool_(true)
 {
     name_ = "connection_pool[" + connector_.get_target() + "](" + std::to_string(pool_max_size_) + ")";
+    next_screening_ = clock_type::now() + std::chrono::seconds(1);
     pool_watcher_ = std::thread([this]() { this->watch_pool_routine(); });
     STREAM_LOG_TRACE(name_ + " has been created");
 }
 
-template <typename Connector, typename Strategy>
+template <typename Connector, typename Strategy, typename Storage>
+template <typename... ArgN>
+base_connection_pool<Connector, Strategy, Storage>::base_connection_pool(background_scheduler& scheduler,
+                                                                         std::size_t size,
+                                                                         time_duration_type idle_timeout,
+                                                                         pool_reuse_order reuse_order, ArgN&&... argn)
+    // the connector registers its resolve task first: due tasks are served in registration
+    // order, so on a single-worker scheduler the initial resolve precedes the first refill
+    : connector_(scheduler, std::forward<ArgN>(argn)...)
+    , pool_max_size_(size)
+    , idle_timeout_(idle_timeout)
+    , sesson_pool_(size, reuse_order)
+    , scheduler_(&scheduler)
+{
+    name_ = "connection_pool[" + connector_.get_target() + "](" + std::to_string(pool_max_size_) + ")";
+    next_screening_ = clock_type::now() + std::chrono::seconds(1);
+    watch_task_ = scheduler_->add([this]() { return this->watch_pool_step(); });
+    STREAM_LOG_TRACE(name_ + " has been created on a shared scheduler");
+}
+
+template <typename Connector, typename Strategy, typename Storage>
+template <typename... ArgN>
+base_connection_pool<Connector, Strategy, Storage>::base_connection_pool(background_scheduler& scheduler,
+                                                                         std::size_t size,
+                                                                         time_duration_type idle_timeout,
+                                                                         ArgN&&... argn)
+    : base_connection_pool(scheduler, size, idle_timeout, pool_reuse_order::fifo, std::forward<ArgN>(argn)...)
+{
+}
+
+template <typename Connector, typename Strategy, typename Storage>
+template <typename... ArgN>
+base_connection_pool<Connector, Strategy, Storage>::base_connection_pool(std::size_t size,
+                                                                         time_duration_type idle_timeout,
+                                                                         ArgN&&... argn)
+    : base_connection_pool(size, idle_timeout, pool_reuse_order::fifo, std::forward<ArgN>(argn)...)
+{
+}
+
+template <typename Connector, typename Strategy, typename Storage>
+template <typename... ArgN>
+base_connection_pool<Connector, Strategy, Storage>::base_connection_pool(std::size_t size, pool_reuse_order reuse_order,
+                                                                         ArgN&&... argn)
+    : base_connection_pool(size, time_duration_type::max(), reuse_order, std::forward<ArgN>(argn)...)
+{
+}
+
+template <typename Connector, typename Strategy, typename Storage>
 template <typename Arg1, typename... ArgN,
-          typename std::enable_if<!std::is_convertible<Arg1, typename Connector::time_duration_type>::value>::type*>
-base_connection_pool<Connector, Strategy>::base_connection_pool(std::size_t size, Arg1&& arg1, ArgN&&... argn)
-    : base_connection_pool(size, time_duration_type::max(), std::forward<Arg1>(arg1), std::forward<ArgN>(argn)...)
+          typename std::enable_if<!std::is_convertible<Arg1, typename Connector::time_duration_type>::value &&
+                                  !std::is_same<typename std::decay<Arg1>::type, pool_reuse_order>::value>::type*>
+base_connection_pool<Connector, Strategy, Storage>::base_connection_pool(std::size_t size, Arg1&& arg1, ArgN&&... argn)
+    : base_connection_pool(size, time_duration_type::max(), pool_reuse_order::fifo, std::forward<Arg1>(arg1),
+                           std::forward<ArgN>(argn)...)
 {
 }
 
-template <typename Connector, typename Strategy>
-base_connection_pool<Connector, Strategy>::~base_connection_pool()
+template <typename Connector, typename Strategy, typename Storage>
+base_connection_pool<Connector, Strategy, Storage>::~base_connection_pool()
 {
+    if (scheduler_ != nullptr) {
+        // guarantees no maintenance round is running or will run past this point
+        scheduler_->remove(watch_task_);
+    }
     watch_pool_.store(false, std::memory_order_release);
+    notify_watcher();
     if (pool_watcher_.joinable()) {
         pool_watcher_.join();
     }
-}
 
-template <typename Connector, typename Strategy>
-bool base_connection_pool<Connector, Strategy>::ensure_session(std::unique_lock<std::timed_mutex>& pool_lk,
-                                                               boost::system::error_code& ec,
-                                                               const time_point_type& deadline) const
-{
-    if (!pool_lk.try_lock_until(deadline)) {
-        // failed to lock pool_mutex_
-        ec = boost::asio::error::timed_out;
-        return false;
+    // fail async waiters which are still queued
+    std::list<session_waiter> abandoned;
+    {
+        std::lock_guard<std::mutex> lk(waiters_mutex_);
+        abandoned.swap(session_waiters_);
     }
-    if (!pool_cv_.wait_until(pool_lk, deadline, [this] { return !sesson_pool_.empty(); })) {
-        // session pool is still empty
-        ec = boost::asio::error::not_found;
-        return false;
+    for (auto& waiter : abandoned) {
+        waiter.handler(boost::asio::error::operation_aborted, nullptr);
     }
-    return true;
 }
 
-template <typename Connector, typename Strategy>
-std::unique_ptr<typename base_connection_pool<Connector, Strategy>::stream_type>
-base_connection_pool<Connector, Strategy>::get_session(boost::system::error_code& ec, const time_point_type& deadline)
+template <typename Connector, typename Strategy, typename Storage>
+std::unique_ptr<typename base_connection_pool<Connector, Strategy, Storage>::stream_type>
+base_connection_pool<Connector, Strategy, Storage>::get_session(boost::system::error_code& ec,
+                                                                const time_point_type& deadline)
 {
-    std::unique_lock<std::timed_mutex> pool_lk(pool_mutex_, std::defer_lock);
-    if (!ensure_session(pool_lk, ec, deadline)) {
-        return nullptr;
+    ::stream_client::detail::trace_scope span(::stream_client::trace_phase::pool_wait);
+    const auto wait_started = clock_type::now();
+    auto session = sesson_pool_.get(ec, deadline);
+    while (session && !detail::session_alive(*session)) {
+        // peer has already closed it, drop and draw another one instead of
+        // handing the caller a session which is guaranteed to fail
+        metrics_.record_dead_evictions(1);
+        session = sesson_pool_.get(ec, deadline);
+    }
+    metrics_.record_acquire(session != nullptr, detail::elapsed_ns(wait_started, clock_type::now()));
+    span.set_error(ec.value());
+    if (session) {
+        // the pull made room in the pool, kick the watcher to start the refill right away
+        notify_watcher();
     }
-
-    std::unique_ptr<stream_type> session = std::move(sesson_pool_.front().second);
-    sesson_pool_.pop_front();
     return session;
 }
 
-template <typename Connector, typename Strategy>
-std::unique_ptr<typename base_connection_pool<Connector, Strategy>::stream_type>
-base_connection_pool<Connector, Strategy>::try_get_session(boost::system::error_code& ec,
-                                                           const time_point_type& deadline)
+template <typename Connector, typename Strategy, typename Storage>
+std::unique_ptr<typename base_connection_pool<Connector, Strategy, Storage>::stream_type>
+base_connection_pool<Connector, Strategy, Storage>::try_get_session(boost::system::error_code& ec,
+                                                                    const time_point_type& deadline)
 {
-    std::unique_lock<std::timed_mutex> pool_lk(pool_mutex_, std::defer_lock);
-    if (!pool_lk.try_lock_until(deadline)) {
-        // failed to lock pool_mutex_
-        ec = boost::asio::error::timed_out;
-        return nullptr;
+    const auto wait_started = clock_type::now();
+    auto session = sesson_pool_.try_get(ec, deadline);
+    while (session && !detail::session_alive(*session)) {
+        metrics_.record_dead_evictions(1);
+        session = sesson_pool_.try_get(ec, deadline);
     }
-    if (sesson_pool_.empty()) {
-        // session pool is empty
-        ec = boost::asio::error::not_found;
-        return nullptr;
+    metrics_.record_acquire(session != nullptr, detail::elapsed_ns(wait_started, clock_type::now()));
+    if (session) {
+        // the pull made room in the pool, kick the watcher to start the refill right away
+        notify_watcher();
     }
-
-    std::unique_ptr<stream_type> session = std::move(sesson_pool_.front().second);
-    sesson_pool_.pop_front();
     return session;
 }
 
-template <typename Connector, typename Strategy>
-void base_connection_pool<Connector, Strategy>::return_session(std::unique_ptr<stream_type>&& session)
+template <typename Connector, typename Strategy, typename Storage>
+void base_connection_pool<Connector, Strategy, Storage>::return_session(std::unique_ptr<stream_type>&& session)
 {
     if (!session || !session->next_layer().is_open()) {
         return;
     }
 
-    std::unique_lock<std::timed_mutex> pool_lk(pool_mutex_, std::defer_lock);
-    if (!pool_lk.try_lock_for(std::chrono::milliseconds(1))) {
-        // if we failed to return session in 1ms it's easier to establish new one
-        STREAM_LOG_INFO(name_ + " has dropped alive session due lock contention");
+    // feed an async waiter directly, bypassing the storage
+    session_waiter waiter;
+    bool have_waiter = false;
+    {
+        std::lock_guard<std::mutex> lk(waiters_mutex_);
+        if (!session_waiters_.empty()) {
+            waiter = std::move(session_waiters_.front());
+            session_waiters_.pop_front();
+            have_waiter = true;
+        }
+    }
+    if (have_waiter) {
+        metrics_.record_acquire(true, detail::elapsed_ns(waiter.started, clock_type::now()));
+        waiter.handler(boost::system::error_code(), std::move(session));
         return;
     }
 
-    sesson_pool_.emplace_back(clock_type::now(), std::move(session));
-    pool_lk.unlock();
-    pool_cv_.notify_one();
+    if (!sesson_pool_.put(clock_type::now(), std::move(session))) {
+        metrics_.record_return(true);
+        STREAM_LOG_INFO(name_ + " has dropped alive session due lock contention");
+    } else {
+        metrics_.record_return(false);
+    }
 }
 
-template <typename Connector, typename Strategy>
-bool base_connection_pool<Connector, Strategy>::is_connected(boost::system::error_code& ec,
-                                                             const time_point_type& deadline) const
+template <typename Connector, typename Strategy, typename Storage>
+bool base_connection_pool<Connector, Strategy, Storage>::warm_up(boost::system::error_code& ec,
+                                                                 const time_point_type& deadline)
 {
-    std::unique_lock<std::timed_mutex> pool_lk(pool_mutex_, std::defer_lock);
-    return ensure_session(pool_lk, ec, deadline);
+    ec = boost::system::error_code();
+
+    const std::size_t stored = sesson_pool_.size();
+    const std::size_t vacant_places = (pool_max_size_ > stored) ? pool_max_size_ - stored : 0;
+    if (vacant_places) {
+        // one worker per vacant place: warm-up is a one-off startup burst, so unlike the
+        // steady-state strategy it connects everything missing simultaneously
+        detail::connect_engine engine(vacant_places);
+        for (std::size_t i = 0; i < vacant_places; ++i) {
+            engine.submit([this, deadline]() {
+                boost::system::error_code session_ec;
+                auto session = connector_.new_session(session_ec, deadline);
+                if (session) {
+                    return_session(std::move(session));
+                }
+            });
+        }
+        // every job is bounded by the deadline, so is this wait
+        engine.wait();
+    }
+    return wait_ready(1.0, ec, deadline);
 }
 
-template <typename Connector, typename Strategy>
-void base_connection_pool<Connector, Strategy>::watch_pool_routine()
+template <typename Connector, typename Strategy, typename Storage>
+bool base_connection_pool<Connector, Strategy, Storage>::wait_ready(double fraction, boost::system::error_code& ec,
+                                                                    const time_point_type& deadline) const
 {
-    static const auto lock_timeout = std::chrono::milliseconds(100);
+    ec = boost::system::error_code();
 
-    while (watch_pool_.load(std::memory_order_acquire)) {
-        // try to lock pool mutex
-        std::unique_lock<std::timed_mutex> pool_lk(pool_mutex_, lock_timeout);
-        if (!pool_lk.owns_lock()) {
-            continue;
+    const double clamped_fraction = std::min(1.0, std::max(0.0, fraction));
+    const auto required = static_cast<std::size_t>(std::ceil(clamped_fraction * static_cast<double>(pool_max_size_)));
+    while (sesson_pool_.size() < required) {
+        if (clock_type::now() >= deadline) {
+            ec = boost::asio::error::timed_out;
+            return false;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    return true;
+}
+
+template <typename Connector, typename Strategy, typename Storage>
+bool base_connection_pool<Connector, Strategy, Storage>::is_connected(boost::system::error_code& ec,
+                                                                      const time_point_type& deadline) const
+{
+    return sesson_pool_.wait_for_session(ec, deadline);
+}
+
+template <typename Connector, typename Strategy, typename Storage>
+typename base_connection_pool<Connector, Strategy, Storage>::time_point_type
+base_connection_pool<Connector, Strategy, Storage>::watch_pool_step()
+{
+    static const auto screening_period = std::chrono::seconds(1);
+
+    // remove session which idling past idle_timeout_
+    std::size_t pool_current_size = 0;
+    std::size_t evicted = 0;
+    time_point_type oldest_added = time_point_type::max();
+    if (!sesson_pool_.remove_idle(clock_type::now(), idle_timeout_, pool_current_size, evicted, oldest_added)) {
+        // the storage is contended, retry right away
+        return clock_type::now();
+    }
+    if (evicted) {
+        metrics_.record_idle_evictions(evicted);
+    }
+
+    // periodically screen stored sessions for peer-closed sockets,
+    // so dead ones are evicted before anyone draws them
+    if (clock_type::now() >= next_screening_) {
+        next_screening_ = clock_type::now() + screening_period;
+        std::size_t dead = 0;
+        if (sesson_pool_.remove_dead([](stream_type& session) { return detail::session_alive(session); }, dead) &&
+            dead > 0) {
+            metrics_.record_dead_evictions(dead);
+            pool_current_size = (pool_current_size > dead) ? pool_current_size - dead : 0;
+        }
+    }
+    metrics_.record_size(pool_current_size);
+
+    // pair queued waiters with sessions already in storage: a session returned between
+    // the async_get_session() probe and its waiter being queued lands in storage with
+    // no one to take it, and with the pool at target size no refill would serve it
+    std::list<std::pair<session_waiter, std::unique_ptr<stream_type>>> served_waiters;
+    {
+        std::lock_guard<std::mutex> lk(waiters_mutex_);
+        while (!session_waiters_.empty()) {
+            boost::system::error_code stored_ec;
+            auto stored_session = sesson_pool_.try_get(stored_ec, clock_type::now());
+            if (!stored_session) {
+                break;
+            }
+            served_waiters.emplace_back(std::move(session_waiters_.front()), std::move(stored_session));
+            session_waiters_.pop_front();
         }
+    }
+    for (auto& served : served_waiters) {
+        metrics_.record_acquire(true, detail::elapsed_ns(served.first.started, clock_type::now()));
+        served.first.handler(boost::system::error_code(), std::move(served.second));
+    }
+    // the served sessions left the storage, account for the freed room below
+    pool_current_size = (pool_current_size > served_waiters.size()) ? pool_current_size - served_waiters.size() : 0;
 
-        // remove session which idling past idle_timeout_
-        std::size_t pool_current_size = 0;
-        const auto now = clock_type::now();
-        for (auto pool_it = sesson_pool_.begin(); pool_it != sesson_pool_.end();) {
-            if (now - pool_it->first >= idle_timeout_) {
-                pool_it = sesson_pool_.erase(pool_it);
+    // fail async waiters whose deadline has passed and schedule the earliest remaining one;
+    // done before the refill so waiters expire even while the pool is busy reconnecting
+    time_point_type next_waiter_deadline = time_point_type::max();
+    std::list<session_waiter> expired_waiters;
+    {
+        std::lock_guard<std::mutex> lk(waiters_mutex_);
+        for (auto waiter_it = session_waiters_.begin(); waiter_it != session_waiters_.end();) {
+            if (waiter_it->deadline <= clock_type::now()) {
+                expired_waiters.splice(expired_waiters.end(), session_waiters_, waiter_it++);
             } else {
-                ++pool_it;
-                ++pool_current_size;
+                next_waiter_deadline = std::min(next_waiter_deadline, waiter_it->deadline);
+                ++waiter_it;
             }
         }
+    }
+    for (auto& waiter : expired_waiters) {
+        waiter.handler(boost::asio::error::timed_out, nullptr);
+    }
 
-        // release pool mutex after removing old sessions
-        pool_lk.unlock();
+    // ask the strategy how many sessions it wants right now; static strategies
+    // just return the configured size, adaptive ones scale it with demand
+    const std::size_t target_size = reconnection_.target_size(pool_max_size_, metrics_);
+    if (target_size < pool_max_size_ && pool_current_size > target_size) {
+        // the strategy scaled down, actively drop the excess to free upstream slots
+        boost::system::error_code trim_ec;
+        for (std::size_t excess = pool_current_size - target_size; excess > 0; --excess) {
+            if (!sesson_pool_.try_get(trim_ec, clock_type::now())) {
+                break;
+            }
+            --pool_current_size;
+        }
+    }
 
-        // pool_current_size may be bigger if someone returned previous session
-        std::size_t vacant_places = (pool_max_size_ > pool_current_size) ? pool_max_size_ - pool_current_size : 0;
+    // pool_current_size may be bigger if someone returned previous session
+    std::size_t vacant_places = (target_size > pool_current_size) ? target_size - pool_current_size : 0;
 
-        if (vacant_places) {
-            auto append_func = [this](std::unique_ptr<stream_type>&& session) {
-                this->return_session(std::move(session));
-            };
-            const auto need_more = reconnection_.refill(connector_, vacant_places, append_func);
-            if (need_more) {
-                continue;
-            }
+    if (vacant_places) {
+        auto append_func = [this](std::unique_ptr<stream_type>&& session) {
+            this->return_session(std::move(session));
+        };
+        const auto refill_started = clock_type::now();
+        const auto need_more = reconnection_.refill(connector_, vacant_places, append_func);
+        metrics_.record_refill(detail::elapsed_ns(refill_started, clock_type::now()));
+        if (need_more) {
+            return clock_type::now();
+        }
+    }
+
+    // nothing to do right now; sleep until the next scheduled event (idle expiry
+    // or liveness screening of stored sessions) or an explicit wake-up from a pull
+    time_point_type wake_at = next_waiter_deadline;
+    if (pool_current_size > 0) {
+        wake_at = std::min(wake_at, next_screening_);
+        if (idle_timeout_ != time_duration_type::max() && oldest_added != time_point_type::max()) {
+            // idle expiry is scheduled off the oldest stored session, not rediscovered by polling
+            wake_at = std::min(wake_at, oldest_added + idle_timeout_);
         }
+    }
+    if (vacant_places) {
+        // refill failed or is backing off, retry shortly
+        wake_at = std::min(wake_at, clock_type::now() + std::chrono::milliseconds(50));
+    }
+    return wake_at;
+}
 
-        // stop cpu spooling if nothing has been added
-        std::this_thread::sleep_for(std::chrono::milliseconds(50));
+template <typename Connector, typename Strategy, typename Storage>
+void base_connection_pool<Connector, Strategy, Storage>::watch_pool_routine()
+{
+    while (watch_pool_.load(std::memory_order_acquire)) {
+        const auto wake_at = watch_pool_step();
+        if (wake_at <= clock_type::now()) {
+            // the step wants to run again right away
+            continue;
+        }
+
+        std::unique_lock<std::mutex> lk(watch_mutex_);
+        const auto wake_condition = [this] {
+            return watch_signal_ || !watch_pool_.load(std::memory_order_acquire);
+        };
+        if (wake_at == time_point_type::max()) {
+            watch_cv_.wait(lk, wake_condition);
+        } else {
+            watch_cv_.wait_until(lk, wake_at, wake_condition);
+        }
+        watch_signal_ = false;
     }
 }
 
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <numeric>
 #include <random>
 
 namespace {
@@ -18,41 +19,115 @@ namespace stream_client {
 namespace connector {
 
 template <typename Stream>
-base_connector<Stream>::base_connector(const std::string& host, const std::string& port,
-                                       time_duration_type resolve_timeout, time_duration_type connect_timeout,
-                                       time_duration_type operation_timeout,
-                                       ::stream_client::resolver::ip_family ip_family, resolve_flags_type resolve_flags)
+const std::size_t base_connector<Stream>::kDefaultRaceCandidates = 2; // race a pair of endpoints by default
+
+template <typename Stream>
+const unsigned long base_connector<Stream>::kDefaultRaceDelayMs = 250; // RFC 8305 recommended stagger delay
+
+template <typename Stream>
+const unsigned long base_connector<Stream>::kDefaultEndpointsTTLMs = 30000; // re-resolve every 30 seconds
+
+template <typename Stream>
+const double base_connector<Stream>::kStatsSmoothing = 0.2; // EWMA weight of the latest attempt
+
+template <typename Stream>
+const std::size_t base_connector<Stream>::kExploreEvery = 8; // every 8th connect uses plain rotation order
+
+template <typename Stream>
+base_connector<Stream>::base_connector(background_scheduler* scheduler, const std::string& host,
+                                       const std::string& port, time_duration_type resolve_timeout,
+                                       time_duration_type connect_timeout, time_duration_type operation_timeout,
+                                       ::stream_client::resolver::ip_family ip_family, resolve_flags_type resolve_flags,
+                                       ::stream_client::socket_profile profile)
     : host_(host)
     , port_(port)
     , resolve_timeout_(resolve_timeout)
     , connect_timeout_(connect_timeout)
     , operation_timeout_(operation_timeout)
     , resolver_(host_, port_, resolve_timeout_, std::move(ip_family), std::move(resolve_flags))
+    , scheduler_(scheduler)
+    , socket_profile_(std::move(profile))
 {
     resolve_done_ = false;
     resolve_needed_ = true;
-    resolving_thread_running_.store(true, std::memory_order_release);
-    resolving_thread_ = std::thread([this]() { this->resolve_routine(); });
+    if (scheduler_ != nullptr) {
+        resolving_thread_running_.store(false, std::memory_order_release);
+        resolve_task_ = scheduler_->add([this]() { return this->resolve_step(); });
+    } else {
+        resolving_thread_running_.store(true, std::memory_order_release);
+        resolving_thread_ = std::thread([this]() { this->resolve_routine(); });
+    }
+}
+
+template <typename Stream>
+base_connector<Stream>::base_connector(const std::string& host, const std::string& port,
+                                       time_duration_type resolve_timeout, time_duration_type connect_timeout,
+                                       time_duration_type operation_timeout,
+                                       ::stream_client::resolver::ip_family ip_family, resolve_flags_type resolve_flags,
+                                       ::stream_client::socket_profile profile)
+    : base_connector(static_cast<background_scheduler*>(nullptr), host, port, std::move(resolve_timeout),
+                     std::move(connect_timeout), std::move(operation_timeout), std::move(ip_family),
+                     std::move(resolve_flags), std::move(profile))
+{
+}
+
+template <typename Stream>
+base_connector<Stream>::base_connector(::stream_client::reactor& io_reactor, const std::string& host,
+                                       const std::string& port, time_duration_type resolve_timeout,
+                                       time_duration_type connect_timeout, time_duration_type operation_timeout,
+                                       ::stream_client::resolver::ip_family ip_family, resolve_flags_type resolve_flags,
+                                       ::stream_client::socket_profile profile)
+    : base_connector(host, port, std::move(resolve_timeout), std::move(connect_timeout), std::move(operation_timeout),
+                     std::move(ip_family), std::move(resolve_flags), std::move(profile))
+{
+    reactor_ = &io_reactor;
+}
+
+template <typename Stream>
+base_connector<Stream>::base_connector(background_scheduler& scheduler, const std::string& host,
+                                       const std::string& port, time_duration_type resolve_timeout,
+                                       time_duration_type connect_timeout, time_duration_type operation_timeout,
+                                       ::stream_client::resolver::ip_family ip_family, resolve_flags_type resolve_flags,
+                                       ::stream_client::socket_profile profile)
+    : base_connector(&scheduler, host, port, std::move(resolve_timeout), std::move(connect_timeout),
+                     std::move(operation_timeout), std::move(ip_family), std::move(resolve_flags), std::move(profile))
+{
 }
 
 template <typename Stream>
 base_connector<Stream>::~base_connector()
 {
+    if (scheduler_ != nullptr) {
+        scheduler_->remove(resolve_task_);
+    }
     resolving_thread_running_.store(false, std::memory_order_release);
     if (resolving_thread_.joinable()) {
         resolving_thread_.join();
     }
+
+    std::unique_lock<std::mutex> race_threads_lk(race_threads_mutex_);
+    for (auto& attempt : race_threads_) {
+        if (attempt.first.joinable()) {
+            attempt.first.join();
+        }
+    }
 }
 
 template <typename Stream>
 std::unique_ptr<typename base_connector<Stream>::stream_type>
 base_connector<Stream>::new_session(boost::system::error_code& ec, const time_point_type& deadline)
 {
+    const auto connect_started = clock_type::now();
+    auto record_connect = [&](bool success) {
+        metrics_.record_connect(success, detail::elapsed_ns(connect_started, clock_type::now()));
+    };
+
     std::unique_lock<std::timed_mutex> resolve_done_lk(resolve_done_mutex_, std::defer_lock);
     if (!resolve_done_lk.try_lock_until(deadline)) {
         // failed to lock resolve_done_mutex_ within deadline
         auto resolve_ec = get_resolve_error();
         ec = resolve_ec ? std::move(resolve_ec) : boost::asio::error::timed_out;
+        record_connect(false);
         return nullptr;
     }
     if (resolve_done_ == false &&
@@ -60,56 +135,299 @@ base_connector<Stream>::new_session(boost::system::error_code& ec, const time_po
         // faield to wait for endpoints resolution
         auto resolve_ec = get_resolve_error();
         ec = resolve_ec ? std::move(resolve_ec) : boost::asio::error::timed_out;
+        record_connect(false);
         return nullptr;
     }
     // unlock owned resolve_done_mutex_ to release other new_session() calls while we are connecting
     resolve_done_lk.unlock();
 
-    auto endpoints = get_endpoints();
-    shuffle_vector(endpoints);
-    for (const auto& peer : endpoints) {
-        try {
-            return connect_until(peer, deadline);
-        } catch (const boost::system::system_error& err) {
-            ec = err.code();
-            break;
+    // single atomic load of the current pre-shuffled snapshot, no lock and no copy
+    const auto endpoints_snapshot = get_endpoints();
+    const auto& endpoints = *endpoints_snapshot;
+    const std::size_t n_endpoints = endpoints.size();
+    const std::size_t start = endpoint_rotation_.fetch_add(1, std::memory_order_relaxed);
+
+    std::size_t candidates;
+    time_duration_type stagger_delay;
+    {
+        std::unique_lock<std::mutex> race_config_lk(race_config_mutex_);
+        candidates = race_candidates_;
+        stagger_delay = race_stagger_delay_;
+    }
+    candidates = std::min(candidates, n_endpoints);
+
+    // weighted choice over per-endpoint stats steers connects toward fast healthy replicas
+    const auto order = pick_endpoints(endpoints, start);
+
+    if (candidates > 1) {
+        endpoint_container_type race_list;
+        race_list.reserve(candidates);
+        for (std::size_t i = 0; i < candidates; ++i) {
+            race_list.emplace_back(endpoints[order[i]]);
+        }
+        auto session = race_connect(race_list, candidates, stagger_delay, ec, deadline);
+        if (session) {
+            record_connect(true);
+            return session;
+        }
+    } else {
+        for (std::size_t i = 0; i < n_endpoints; ++i) {
+            const auto& peer = endpoints[order[i]];
+            const auto attempt_started = clock_type::now();
+            try {
+                auto session = connect_until(peer, deadline);
+                record_endpoint_result(peer, true, detail::elapsed_ns(attempt_started, clock_type::now()));
+                record_connect(true);
+                return session;
+            } catch (const boost::system::system_error& err) {
+                record_endpoint_result(peer, false, detail::elapsed_ns(attempt_started, clock_type::now()));
+                ec = err.code();
+                break;
+            }
         }
     }
     if (!ec) {
         // endpoints may be empty because of resolve error
         ec = get_resolve_error();
     }
+    record_connect(false);
     // if failed to connect trigger resolving thread to update endpoints
     notify_resolve_needed();
     return nullptr;
 }
 
+template <typename Stream>
+std::unique_ptr<typename base_connector<Stream>::stream_type>
+base_connector<Stream>::race_connect(const endpoint_container_type& endpoints, std::size_t candidates,
+                                     const time_duration_type& stagger_delay, boost::system::error_code& ec,
+                                     const time_point_type& deadline)
+{
+    // attempts may outlive this call, so the shared scoreboard is ref-counted
+    struct race_state
+    {
+        std::mutex mutex;
+        std::condition_variable cv;
+        std::unique_ptr<stream_type> winner;
+        boost::system::error_code first_error;
+        std::size_t finished{0};
+    };
+    auto state = std::make_shared<race_state>();
+
+    std::size_t launched = 0;
+    auto launch_next = [&]() {
+        const auto peer = endpoints[launched++];
+        auto done_flag = std::make_shared<std::atomic_bool>(false);
+        std::thread attempt_thread([this, peer, deadline, state, done_flag]() {
+            std::unique_ptr<stream_type> session;
+            boost::system::error_code attempt_ec;
+            const auto attempt_started = clock_type::now();
+            try {
+                session = connect_until(peer, deadline);
+            } catch (const boost::system::system_error& err) {
+                attempt_ec = err.code();
+            }
+            record_endpoint_result(peer, static_cast<bool>(session),
+                                   detail::elapsed_ns(attempt_started, clock_type::now()));
+
+            std::unique_lock<std::mutex> state_lk(state->mutex);
+            if (session && !state->winner) {
+                state->winner = std::move(session);
+            } else if (attempt_ec && !state->first_error) {
+                state->first_error = attempt_ec;
+            }
+            ++state->finished;
+            state_lk.unlock();
+            // a late session (if any) is destroyed here which closes its socket
+            state->cv.notify_all();
+            done_flag->store(true, std::memory_order_release);
+        });
+        add_race_thread(std::move(attempt_thread), std::move(done_flag));
+    };
+
+    while (launched < candidates) {
+        launch_next();
+        const auto stagger_deadline = std::min(deadline, clock_type::now() + stagger_delay);
+
+        std::unique_lock<std::mutex> state_lk(state->mutex);
+        state->cv.wait_until(state_lk, stagger_deadline,
+                             [&]() { return state->winner || state->finished == launched; });
+        if (state->winner) {
+            return std::move(state->winner);
+        }
+        if (clock_type::now() >= deadline) {
+            break;
+        }
+        // stagger delay elapsed or all running attempts failed - start the next one
+    }
+
+    // every candidate is in flight, wait out the result
+    std::unique_lock<std::mutex> state_lk(state->mutex);
+    state->cv.wait_until(state_lk, deadline, [&]() { return state->winner || state->finished == launched; });
+    if (state->winner) {
+        return std::move(state->winner);
+    }
+    ec = state->first_error ? state->first_error : boost::system::error_code(boost::asio::error::timed_out);
+    return nullptr;
+}
+
+template <typename Stream>
+void base_connector<Stream>::add_race_thread(std::thread&& attempt_thread, std::shared_ptr<std::atomic_bool> done_flag)
+{
+    std::unique_lock<std::mutex> race_threads_lk(race_threads_mutex_);
+    // reap attempts that have already finished
+    for (auto it = race_threads_.begin(); it != race_threads_.end();) {
+        if (it->second->load(std::memory_order_acquire)) {
+            it->first.join();
+            it = race_threads_.erase(it);
+        } else {
+            ++it;
+        }
+    }
+    race_threads_.emplace_back(std::move(attempt_thread), std::move(done_flag));
+}
+
+template <typename Stream>
+void base_connector<Stream>::record_endpoint_result(const endpoint_type& peer_endpoint, bool success,
+                                                    std::uint64_t latency_ns)
+{
+    std::lock_guard<std::mutex> stats_lk(endpoint_stats_mutex_);
+    auto& stats = endpoint_stats_[peer_endpoint];
+    stats.failure_rate += kStatsSmoothing * ((success ? 0.0 : 1.0) - stats.failure_rate);
+    if (success) {
+        // first success seeds the average, later ones get smoothed in
+        stats.latency_ns = stats.connected ? stats.latency_ns +
+                                                 kStatsSmoothing * (static_cast<double>(latency_ns) - stats.latency_ns)
+                                           : static_cast<double>(latency_ns);
+        stats.connected = true;
+    }
+}
+
+template <typename Stream>
+std::vector<std::size_t> base_connector<Stream>::pick_endpoints(const endpoint_container_type& endpoints,
+                                                                std::size_t start) const
+{
+    const std::size_t n_endpoints = endpoints.size();
+    std::vector<std::size_t> order(n_endpoints);
+    std::iota(order.begin(), order.end(), 0);
+    if (n_endpoints < 2) {
+        return order;
+    }
+    // rotation spreads exploration and cold-start traffic across the pre-shuffled snapshot
+    std::rotate(order.begin(), order.begin() + (start % n_endpoints), order.end());
+    if (start % kExploreEvery == 0) {
+        // exploration pick: plain rotation order gives slow or recovered endpoints a go
+        return order;
+    }
+
+    std::vector<double> weights(n_endpoints);
+    {
+        std::lock_guard<std::mutex> stats_lk(endpoint_stats_mutex_);
+        for (std::size_t i = 0; i < n_endpoints; ++i) {
+            const auto stats_it = endpoint_stats_.find(endpoints[order[i]]);
+            if (stats_it == endpoint_stats_.end()) {
+                // an endpoint with no history is tried optimistically
+                weights[i] = 1.0;
+                continue;
+            }
+            const auto& stats = stats_it->second;
+            const double health = 1.0 - stats.failure_rate;
+            // smoothed connect latency discounts the weight once the endpoint has connected
+            const double speed = stats.connected ? 1.0 / (1.0 + stats.latency_ns / 1e6) : 1.0;
+            // the floor keeps even the worst endpoint reachable between exploration picks
+            weights[i] = std::max(health * speed, 0.01);
+        }
+    }
+
+    // the generator survives between calls, a connect only pays for the draws themselves
+    thread_local std::minstd_rand r_generator(std::random_device{}());
+
+    // weighted sampling without replacement: on average the fastest healthy endpoint goes first
+    for (std::size_t picked = 0; picked + 1 < n_endpoints; ++picked) {
+        double total = 0.0;
+        for (std::size_t i = picked; i < n_endpoints; ++i) {
+            total += weights[i];
+        }
+        std::uniform_real_distribution<double> pick_point(0.0, total);
+        double point = pick_point(r_generator);
+        std::size_t chosen = picked;
+        for (std::size_t i = picked; i < n_endpoints; ++i) {
+            point -= weights[i];
+            if (point <= 0.0) {
+                chosen = i;
+                break;
+            }
+        }
+        std::swap(order[picked], order[chosen]);
+        std::swap(weights[picked], weights[chosen]);
+    }
+    return order;
+}
+
+template <typename Stream>
+void base_connector<Stream>::update_endpoints(resolver_endpoint_iterator_type&& resolved_endpoints)
+{
+    auto new_endpoints = std::make_shared<endpoint_container_type>();
+    while (resolved_endpoints != resolver_endpoint_iterator_type()) {
+        new_endpoints->emplace_back(std::move(*resolved_endpoints));
+        ++resolved_endpoints;
+    }
+
+    // snapshot is shuffled once here so the connect path can walk it in rotation order
+    shuffle_vector(*new_endpoints);
+    std::atomic_store(&endpoints_, std::shared_ptr<const endpoint_container_type>(std::move(new_endpoints)));
+}
+
+template <typename Stream>
+typename base_connector<Stream>::time_point_type base_connector<Stream>::resolve_step()
+{
+    std::unique_lock<std::timed_mutex> resolve_needed_lk(resolve_needed_mutex_, std::chrono::milliseconds(100));
+    if (!resolve_needed_lk.owns_lock()) {
+        // the trigger storage is contended, retry shortly
+        return clock_type::now() + std::chrono::milliseconds(10);
+    }
+    if (!resolve_needed_ && clock_type::now() < next_refresh_) {
+        // nothing to do until the snapshot expires or an explicit trigger arrives
+        return next_refresh_;
+    }
+
+    boost::system::error_code resolve_ec;
+    resolver_endpoint_iterator_type new_endpoints = resolver_.resolve(resolve_ec);
+    set_resolve_error(resolve_ec);
+    metrics_.record_resolve(!resolve_ec);
+    if (resolve_ec) {
+        // failed resolve is retried with a small backoff
+        return clock_type::now() + std::chrono::milliseconds(50);
+    }
+
+    resolve_needed_ = false;
+    next_refresh_ = clock_type::now() + std::chrono::milliseconds(endpoints_ttl_ms_.load(std::memory_order_relaxed));
+    update_endpoints(std::move(new_endpoints));
+    resolve_needed_lk.unlock();
+    notify_resolve_done();
+    return next_refresh_;
+}
+
 template <typename Stream>
 void base_connector<Stream>::resolve_routine()
 {
     static const auto lock_timeout = std::chrono::milliseconds(100);
 
     while (resolving_thread_running_.load(std::memory_order_acquire)) {
-        std::unique_lock<std::timed_mutex> resolve_needed_lk(resolve_needed_mutex_, lock_timeout);
-        if (!resolve_needed_lk.owns_lock() ||
-            !resolve_needed_cv_.wait_for(resolve_needed_lk, lock_timeout, [this] { return resolve_needed_; })) {
-            continue;
+        {
+            std::unique_lock<std::timed_mutex> resolve_needed_lk(resolve_needed_mutex_, lock_timeout);
+            if (!resolve_needed_lk.owns_lock() ||
+                !resolve_needed_cv_.wait_for(resolve_needed_lk, lock_timeout, [this] {
+                    return resolve_needed_ || clock_type::now() >= next_refresh_;
+                })) {
+                continue;
+            }
         }
-        // at this point we owe locked resolve_needed_mutex_
-
-        boost::system::error_code resolve_ec;
-        resolver_endpoint_iterator_type new_endpoints = resolver_.resolve(resolve_ec);
-        set_resolve_error(resolve_ec);
-        if (resolve_ec) {
-            resolve_needed_lk.unlock();
-            std::this_thread::sleep_for(std::chrono::milliseconds(50));
-            continue;
+        const auto wake_at = resolve_step();
+        const auto now = clock_type::now();
+        if (wake_at > now && wake_at < now + lock_timeout) {
+            // resolve failed or the trigger storage was contended, honour the backoff
+            std::this_thread::sleep_for(wake_at - now);
         }
-
-        resolve_needed_ = false;
-        update_endpoints(std::move(new_endpoints));
-        resolve_needed_lk.unlock();
-        notify_resolve_done();
     }
 }
 
@@ -120,7 +438,12 @@ base_connector<::stream_client::tcp_client>::connect_until(const endpoint_type&
                                                            const time_point_type& until_time) const
 {
     const time_duration_type connect_timeout{until_time - clock_type::now()};
-    return std::make_unique<::stream_client::tcp_client>(peer_endpoint, connect_timeout, operation_timeout_);
+    if (reactor_) {
+        return std::make_unique<::stream_client::tcp_client>(*reactor_, peer_endpoint, connect_timeout,
+                                                             operation_timeout_, get_socket_profile());
+    }
+    return std::make_unique<::stream_client::tcp_client>(peer_endpoint, connect_timeout, operation_timeout_,
+                                                         get_socket_profile());
 }
 
 // connect_until specialization for udp_client
@@ -130,7 +453,12 @@ base_connector<::stream_client::udp_client>::connect_until(const endpoint_type&
                                                            const time_point_type& until_time) const
 {
     const time_duration_type connect_timeout{until_time - clock_type::now()};
-    return std::make_unique<::stream_client::udp_client>(peer_endpoint, connect_timeout, operation_timeout_);
+    if (reactor_) {
+        return std::make_unique<::stream_client::udp_client>(*reactor_, peer_endpoint, connect_timeout,
+                                                             operation_timeout_, get_socket_profile());
+    }
+    return std::make_unique<::stream_client::udp_client>(peer_endpoint, connect_timeout, operation_timeout_,
+                                                         get_socket_profile());
 }
 
 // connect_until specialization for ssl::ssl_client
@@ -140,8 +468,13 @@ base_connector<::stream_client::ssl::ssl_client>::connect_until(const endpoint_t
                                                                 const time_point_type& until_time) const
 {
     const time_duration_type connect_timeout{until_time - clock_type::now()};
+    if (reactor_) {
+        return std::make_unique<::stream_client::ssl::ssl_client>(*reactor_, peer_endpoint, connect_timeout,
+                                                                  operation_timeout_, host_, true,
+                                                                  get_socket_profile());
+    }
     return std::make_unique<::stream_client::ssl::ssl_client>(peer_endpoint, connect_timeout, operation_timeout_,
-                                                              host_);
+                                                              host_, true, get_socket_profile());
 }
 
 // connect_until specialization for http_client
@@ -151,7 +484,12 @@ base_connector<::stream_client::http::http_client>::connect_until(const endpoint
                                                                   const time_point_type& until_time) const
 {
     const time_duration_type connect_timeout{until_time - clock_type::now()};
-    return std::make_unique<::stream_client::http::http_client>(peer_endpoint, connect_timeout, operation_timeout_);
+    if (reactor_) {
+        return std::make_unique<::stream_client::http::http_client>(*reactor_, peer_endpoint, connect_timeout,
+                                                                    operation_timeout_, get_socket_profile());
+    }
+    return std::make_unique<::stream_client::http::http_client>(peer_endpoint, connect_timeout, operation_timeout_,
+                                                                get_socket_profile());
 }
 
 // connect_until specialization for https_client
@@ -161,8 +499,13 @@ base_connector<::stream_client::http::https_client>::connect_until(const endpoin
                                                                    const time_point_type& until_time) const
 {
     const time_duration_type connect_timeout{until_time - clock_type::now()};
+    if (reactor_) {
+        return std::make_unique<::stream_client::http::https_client>(*reactor_, peer_endpoint, connect_timeout,
+                                                                     operation_timeout_, host_, true,
+                                                                     get_socket_profile());
+    }
     return std::make_unique<::stream_client::http::https_client>(peer_endpoint, connect_timeout, operation_timeout_,
-                                                                 host_);
+                                                                 host_, true, get_socket_profile());
 }
 
 } // namespace connector
@@ -0,0 +1,344 @@
+#pragma once
+
+#include <boost/asio/error.hpp>
+
+namespace stream_client {
+namespace connector {
+
+template <typename Connector>
+list_pool_storage<Connector>::list_pool_storage(std::size_t /*size*/, pool_reuse_order reuse_order)
+    : reuse_order_(reuse_order)
+{
+}
+
+template <typename Connector>
+std::unique_ptr<typename list_pool_storage<Connector>::stream_type> list_pool_storage<Connector>::pop_session()
+{
+    if (reuse_order_ == pool_reuse_order::lifo) {
+        // most-recently-returned session is the warmest one
+        std::unique_ptr<stream_type> session = std::move(sessions_.back().second);
+        sessions_.pop_back();
+        return session;
+    }
+    std::unique_ptr<stream_type> session = std::move(sessions_.front().second);
+    sessions_.pop_front();
+    return session;
+}
+
+template <typename Connector>
+std::unique_ptr<typename list_pool_storage<Connector>::stream_type>
+list_pool_storage<Connector>::get(boost::system::error_code& ec, const time_point_type& deadline)
+{
+    std::unique_lock<std::timed_mutex> lk(mutex_, std::defer_lock);
+    if (!lk.try_lock_until(deadline)) {
+        // failed to lock mutex_
+        ec = boost::asio::error::timed_out;
+        return nullptr;
+    }
+    if (!cv_.wait_until(lk, deadline, [this] { return !sessions_.empty(); })) {
+        // session storage is still empty
+        ec = boost::asio::error::not_found;
+        return nullptr;
+    }
+
+    return pop_session();
+}
+
+template <typename Connector>
+std::unique_ptr<typename list_pool_storage<Connector>::stream_type>
+list_pool_storage<Connector>::try_get(boost::system::error_code& ec, const time_point_type& deadline)
+{
+    std::unique_lock<std::timed_mutex> lk(mutex_, std::defer_lock);
+    if (!lk.try_lock_until(deadline)) {
+        // failed to lock mutex_
+        ec = boost::asio::error::timed_out;
+        return nullptr;
+    }
+    if (sessions_.empty()) {
+        // session storage is empty
+        ec = boost::asio::error::not_found;
+        return nullptr;
+    }
+
+    return pop_session();
+}
+
+template <typename Connector>
+bool list_pool_storage<Connector>::put(const time_point_type& added, std::unique_ptr<stream_type>&& session)
+{
+    std::unique_lock<std::timed_mutex> lk(mutex_, std::defer_lock);
+    if (!lk.try_lock_for(std::chrono::milliseconds(1))) {
+        // if we failed to store session in 1ms it's easier to establish new one
+        return false;
+    }
+
+    sessions_.emplace_back(added, std::move(session));
+    lk.unlock();
+    cv_.notify_one();
+    return true;
+}
+
+template <typename Connector>
+bool list_pool_storage<Connector>::wait_for_session(boost::system::error_code& ec,
+                                                    const time_point_type& deadline) const
+{
+    std::unique_lock<std::timed_mutex> lk(mutex_, std::defer_lock);
+    if (!lk.try_lock_until(deadline)) {
+        // failed to lock mutex_
+        ec = boost::asio::error::timed_out;
+        return false;
+    }
+    if (!cv_.wait_until(lk, deadline, [this] { return !sessions_.empty(); })) {
+        // session storage is still empty
+        ec = boost::asio::error::not_found;
+        return false;
+    }
+    return true;
+}
+
+template <typename Connector>
+bool list_pool_storage<Connector>::remove_idle(const time_point_type& now, const time_duration_type& idle_timeout,
+                                               std::size_t& remaining, std::size_t& removed, time_point_type& oldest)
+{
+    static const auto lock_timeout = std::chrono::milliseconds(100);
+
+    std::unique_lock<std::timed_mutex> lk(mutex_, lock_timeout);
+    if (!lk.owns_lock()) {
+        return false;
+    }
+
+    std::size_t current_size = 0;
+    std::size_t removed_count = 0;
+    time_point_type oldest_added = time_point_type::max();
+    for (auto session_it = sessions_.begin(); session_it != sessions_.end();) {
+        if (now - session_it->first >= idle_timeout) {
+            session_it = sessions_.erase(session_it);
+            ++removed_count;
+        } else {
+            oldest_added = std::min(oldest_added, session_it->first);
+            ++session_it;
+            ++current_size;
+        }
+    }
+    remaining = current_size;
+    removed = removed_count;
+    oldest = oldest_added;
+    return true;
+}
+
+template <typename Connector>
+bool list_pool_storage<Connector>::remove_dead(const std::function<bool(stream_type&)>& is_alive,
+                                               std::size_t& removed)
+{
+    static const auto lock_timeout = std::chrono::milliseconds(100);
+
+    std::unique_lock<std::timed_mutex> lk(mutex_, lock_timeout);
+    if (!lk.owns_lock()) {
+        return false;
+    }
+
+    std::size_t removed_count = 0;
+    for (auto session_it = sessions_.begin(); session_it != sessions_.end();) {
+        if (!is_alive(*session_it->second)) {
+            session_it = sessions_.erase(session_it);
+            ++removed_count;
+        } else {
+            ++session_it;
+        }
+    }
+    removed = removed_count;
+    return true;
+}
+
+namespace detail {
+
+/// Round @p value up to the closest power of two.
+inline std::size_t ceil_pow2(std::size_t value)
+{
+    std::size_t result = 2;
+    while (result < value) {
+        result <<= 1;
+    }
+    return result;
+}
+
+} // namespace detail
+
+template <typename Connector>
+mpmc_pool_storage<Connector>::mpmc_pool_storage(std::size_t size, pool_reuse_order reuse_order)
+{
+    if (reuse_order != pool_reuse_order::fifo) {
+        throw std::runtime_error("mpmc_pool_storage supports only fifo reuse order");
+    }
+    // x2 pool size: refill and in-flight returns may briefly overshoot it
+    const std::size_t capacity = detail::ceil_pow2(2 * std::max<std::size_t>(size, 1));
+    mask_ = capacity - 1;
+    cells_ = std::make_unique<cell_type[]>(capacity);
+    for (std::size_t i = 0; i < capacity; ++i) {
+        cells_[i].sequence.store(i, std::memory_order_relaxed);
+    }
+}
+
+template <typename Connector>
+bool mpmc_pool_storage<Connector>::try_enqueue(item_type&& item)
+{
+    std::size_t pos = enqueue_pos_.load(std::memory_order_relaxed);
+    while (true) {
+        cell_type& cell = cells_[pos & mask_];
+        const std::size_t seq = cell.sequence.load(std::memory_order_acquire);
+        const std::ptrdiff_t diff = static_cast<std::ptrdiff_t>(seq) - static_cast<std::ptrdiff_t>(pos);
+        if (diff == 0) {
+            if (enqueue_pos_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                cell.item = std::move(item);
+                cell.sequence.store(pos + 1, std::memory_order_release);
+                return true;
+            }
+        } else if (diff < 0) {
+            // the ring is full
+            return false;
+        } else {
+            pos = enqueue_pos_.load(std::memory_order_relaxed);
+        }
+    }
+}
+
+template <typename Connector>
+bool mpmc_pool_storage<Connector>::try_dequeue(item_type& item)
+{
+    std::size_t pos = dequeue_pos_.load(std::memory_order_relaxed);
+    while (true) {
+        cell_type& cell = cells_[pos & mask_];
+        const std::size_t seq = cell.sequence.load(std::memory_order_acquire);
+        const std::ptrdiff_t diff = static_cast<std::ptrdiff_t>(seq) - static_cast<std::ptrdiff_t>(pos + 1);
+        if (diff == 0) {
+            if (dequeue_pos_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                item = std::move(cell.item);
+                cell.sequence.store(pos + mask_ + 1, std::memory_order_release);
+                return true;
+            }
+        } else if (diff < 0) {
+            // the ring is empty
+            return false;
+        } else {
+            pos = dequeue_pos_.load(std::memory_order_relaxed);
+        }
+    }
+}
+
+template <typename Connector>
+std::unique_ptr<typename mpmc_pool_storage<Connector>::stream_type>
+mpmc_pool_storage<Connector>::get(boost::system::error_code& ec, const time_point_type& deadline)
+{
+    item_type item;
+    if (try_dequeue(item)) {
+        return std::move(item.second);
+    }
+
+    std::unique_lock<std::mutex> lk(wait_mutex_);
+    while (!try_dequeue(item)) {
+        if (wait_cv_.wait_until(lk, deadline) == std::cv_status::timeout) {
+            if (try_dequeue(item)) {
+                break;
+            }
+            // session storage is still empty
+            ec = boost::asio::error::not_found;
+            return nullptr;
+        }
+    }
+    return std::move(item.second);
+}
+
+template <typename Connector>
+std::unique_ptr<typename mpmc_pool_storage<Connector>::stream_type>
+mpmc_pool_storage<Connector>::try_get(boost::system::error_code& ec, const time_point_type& /*deadline*/)
+{
+    item_type item;
+    if (!try_dequeue(item)) {
+        // session storage is empty
+        ec = boost::asio::error::not_found;
+        return nullptr;
+    }
+    return std::move(item.second);
+}
+
+template <typename Connector>
+bool mpmc_pool_storage<Connector>::put(const time_point_type& added, std::unique_ptr<stream_type>&& session)
+{
+    if (!try_enqueue(item_type(added, std::move(session)))) {
+        // the ring is full, session is dropped as excess
+        return false;
+    }
+    {
+        // order the enqueue with a waiter's predicate check; without the lock the
+        // notification may slip in between a failed try_dequeue and the wait,
+        // leaving the consumer asleep with a session sitting in the ring
+        std::lock_guard<std::mutex> lk(wait_mutex_);
+    }
+    wait_cv_.notify_one();
+    return true;
+}
+
+template <typename Connector>
+bool mpmc_pool_storage<Connector>::wait_for_session(boost::system::error_code& ec,
+                                                    const time_point_type& deadline) const
+{
+    if (size() > 0) {
+        return true;
+    }
+
+    std::unique_lock<std::mutex> lk(wait_mutex_);
+    if (!wait_cv_.wait_until(lk, deadline, [this] { return size() > 0; })) {
+        // session storage is still empty
+        ec = boost::asio::error::not_found;
+        return false;
+    }
+    return true;
+}
+
+template <typename Connector>
+bool mpmc_pool_storage<Connector>::remove_idle(const time_point_type& now, const time_duration_type& idle_timeout,
+                                               std::size_t& remaining, std::size_t& removed, time_point_type& oldest)
+{
+    item_type item;
+    std::size_t removed_count = 0;
+    time_point_type oldest_added = time_point_type::max();
+    // rotate through the ring once, like remove_dead(); stopping at the first fresh
+    // item would re-enqueue it at the tail and destroy the FIFO order this scan
+    // (and the reported oldest timestamp) depends on
+    for (std::size_t left = size(); left > 0 && try_dequeue(item); --left) {
+        if (now - item.first >= idle_timeout) {
+            // drop expired session
+            item.second.reset();
+            ++removed_count;
+            continue;
+        }
+        oldest_added = std::min(oldest_added, item.first);
+        put(item.first, std::move(item.second));
+    }
+    remaining = size();
+    removed = removed_count;
+    oldest = oldest_added;
+    return true;
+}
+
+template <typename Connector>
+bool mpmc_pool_storage<Connector>::remove_dead(const std::function<bool(stream_type&)>& is_alive,
+                                               std::size_t& removed)
+{
+    item_type item;
+    std::size_t removed_count = 0;
+    // rotate through the ring once; alive sessions are re-enqueued with their original timestamps
+    for (std::size_t left = size(); left > 0 && try_dequeue(item); --left) {
+        if (!is_alive(*item.second)) {
+            item.second.reset();
+            ++removed_count;
+            continue;
+        }
+        put(item.first, std::move(item.second));
+    }
+    removed = removed_count;
+    return true;
+}
+
+} // namespace connector
+} // namespace stream_client
@@ -6,10 +6,7 @@
 
 #include <atomic>
 #include <chrono>
-#include <list>
 #include <random>
-#include <thread>
-#include <vector>
 
 namespace stream_client {
 namespace connector {
@@ -27,7 +24,8 @@ template <typename Connector>
 bool greedy_strategy<Connector>::refill(connector_type& connector, std::size_t vacant_places,
                                         append_func_type append_func)
 {
-    // creating new sessions may be slow and we want to add them simultaneously
+    // creating new sessions may be slow and we want to add them simultaneously,
+    // so connects are spread over the persistent engine workers
     auto add_session = [&]() {
         try {
             auto new_session = connector.new_session();
@@ -37,13 +35,10 @@ bool greedy_strategy<Connector>::refill(connector_type& connector, std::size_t v
         }
     };
 
-    std::list<std::thread> adders;
     for (std::size_t i = 0; i < vacant_places; ++i) {
-        adders.emplace_back(add_session);
-    }
-    for (auto& a : adders) {
-        a.join();
+        engine_.submit(add_session);
     }
+    engine_.wait();
 
     return vacant_places > 0;
 }
@@ -70,7 +65,8 @@ bool conservative_strategy<Connector>::refill(connector_type& connector, std::si
 
     std::atomic_bool is_added{false};
 
-    // creating new sessions may be slow and we want to add them simultaneously
+    // creating new sessions may be slow and we want to add them simultaneously,
+    // so connects are spread over the persistent engine workers
     auto add_session = [&]() {
         try {
             auto new_session = connector.new_session();
@@ -81,18 +77,14 @@ bool conservative_strategy<Connector>::refill(connector_type& connector, std::si
         }
     };
 
-    std::vector<std::thread> adders;
     const size_t parallel = (vacant_places + 2) / 3 - 1;
     if (!current_delay_ms_ && parallel > 0) {
-        adders.reserve(parallel);
         for (std::size_t i = 0; i < parallel; ++i) {
-            adders.emplace_back(add_session);
+            engine_.submit(add_session);
         }
     }
     add_session();
-    for (auto& a : adders) {
-        a.join();
-    }
+    engine_.wait();
 
     if (is_added) {
         current_delay_ms_ = 0;
@@ -114,5 +106,64 @@ bool conservative_strategy<Connector>::refill(connector_type& connector, std::si
     return false;
 }
 
+template <typename Connector>
+const unsigned long adaptive_strategy<Connector>::kEvalPeriodMs = 1000; // re-evaluate demand once a second
+
+template <typename Connector>
+const unsigned long adaptive_strategy<Connector>::kGrowWaitThresholdNs = 1000000; // 1ms average wait means starvation
+
+template <typename Connector>
+adaptive_strategy<Connector>::adaptive_strategy(std::size_t min_size, std::size_t max_size)
+    : min_size_(min_size)
+    , max_size_(max_size)
+{
+    if (min_size_ < 1 || max_size_ < min_size_) {
+        throw std::runtime_error("adaptive bounds should satisfy 1 <= min <= max");
+    }
+}
+
+template <typename Connector>
+std::size_t adaptive_strategy<Connector>::target_size(std::size_t configured_size, const pool_metrics& metrics)
+{
+    if (current_target_ == 0) {
+        // first call: derive default bounds and start from the configured size
+        if (max_size_ == 0) {
+            max_size_ = std::max<std::size_t>(configured_size, 1);
+            min_size_ = std::max<std::size_t>(max_size_ / 10, 1);
+        }
+        current_target_ = std::min(std::max(std::max<std::size_t>(configured_size, 1), min_size_), max_size_);
+        next_eval_ = clock_type::now() + std::chrono::milliseconds(kEvalPeriodMs);
+        last_stats_ = metrics.snapshot();
+        return current_target_;
+    }
+
+    const auto now = clock_type::now();
+    if (now < next_eval_) {
+        return current_target_;
+    }
+    next_eval_ = now + std::chrono::milliseconds(kEvalPeriodMs);
+
+    const auto stats = metrics.snapshot();
+    const std::uint64_t acquires = stats.acquires - last_stats_.acquires;
+    const std::uint64_t misses = stats.acquire_misses - last_stats_.acquire_misses;
+    const std::uint64_t wait_ns = stats.acquire_wait_ns - last_stats_.acquire_wait_ns;
+    const double rate = double(acquires) * 1000.0 / kEvalPeriodMs; // acquires per second
+    const std::uint64_t avg_wait_ns = acquires ? wait_ns / acquires : 0;
+
+    std::size_t new_target = current_target_;
+    if (misses > 0 || avg_wait_ns > kGrowWaitThresholdNs || (last_rate_ > 0.0 && rate > last_rate_ * 2)) {
+        // clients are waiting for sessions or demand is ramping up, pre-grow by half
+        new_target = current_target_ + std::max<std::size_t>(current_target_ / 2, 1);
+    } else if (rate < double(current_target_)) {
+        // less than one acquire per pooled session per second, scale down gently
+        new_target = current_target_ - std::max<std::size_t>(current_target_ / 10, 1);
+    }
+
+    last_stats_ = stats;
+    last_rate_ = rate;
+    current_target_ = std::min(std::max(new_target, min_size_), max_size_);
+    return current_target_;
+}
+
 } // namespace connector
 } // namespace stream_client
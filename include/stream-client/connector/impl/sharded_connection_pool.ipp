@@ -0,0 +1,181 @@
+#pragma once
+
+#include <random>
+#include <stdexcept>
+#include <thread>
+
+namespace stream_client {
+namespace connector {
+
+template <typename Connector, typename Strategy, typename Storage>
+template <typename... ArgN>
+sharded_connection_pool<Connector, Strategy, Storage>::sharded_connection_pool(
+    std::size_t size, time_duration_type idle_timeout, const std::vector<endpoint_type>& endpoints, ArgN&&... argn)
+{
+    if (endpoints.empty()) {
+        throw std::runtime_error("sharded_connection_pool requires at least one endpoint");
+    }
+    shards_.reserve(endpoints.size());
+    for (const auto& endpoint : endpoints) {
+        // argn are copied, not forwarded: every shard's connector gets the same arguments
+        shards_.emplace_back(
+            std::make_unique<shard_pool_type>(size, idle_timeout, endpoint.first, endpoint.second, argn...));
+    }
+}
+
+template <typename Connector, typename Strategy, typename Storage>
+template <typename... ArgN>
+sharded_connection_pool<Connector, Strategy, Storage>::sharded_connection_pool(
+    std::size_t size, const std::vector<endpoint_type>& endpoints, ArgN&&... argn)
+    : sharded_connection_pool(size, time_duration_type::max(), endpoints, std::forward<ArgN>(argn)...)
+{
+}
+
+template <typename Connector, typename Strategy, typename Storage>
+std::unique_ptr<typename sharded_connection_pool<Connector, Strategy, Storage>::stream_type>
+sharded_connection_pool<Connector, Strategy, Storage>::get_session(boost::system::error_code& ec,
+                                                                   const time_point_type& deadline)
+{
+    const auto choice = pick_two();
+    const std::size_t preferred = better_shard(choice.first, choice.second) ? choice.first : choice.second;
+    const std::size_t fallback = (preferred == choice.first) ? choice.second : choice.first;
+
+    auto session = shards_[preferred]->try_get_session(ec, clock_type::now());
+    std::size_t origin = preferred;
+    if (!session && fallback != preferred) {
+        session = shards_[fallback]->try_get_session(ec, clock_type::now());
+        origin = fallback;
+    }
+    if (!session) {
+        // both picks are empty, wait for the better one to refill
+        session = shards_[preferred]->get_session(ec, deadline);
+        origin = preferred;
+    }
+    if (session) {
+        remember_origin(*session, origin);
+    }
+    return session;
+}
+
+template <typename Connector, typename Strategy, typename Storage>
+std::unique_ptr<typename sharded_connection_pool<Connector, Strategy, Storage>::stream_type>
+sharded_connection_pool<Connector, Strategy, Storage>::try_get_session(boost::system::error_code& ec,
+                                                                       const time_point_type& deadline)
+{
+    const auto choice = pick_two();
+    const std::size_t preferred = better_shard(choice.first, choice.second) ? choice.first : choice.second;
+    const std::size_t fallback = (preferred == choice.first) ? choice.second : choice.first;
+
+    auto session = shards_[preferred]->try_get_session(ec, deadline);
+    std::size_t origin = preferred;
+    if (!session && fallback != preferred) {
+        session = shards_[fallback]->try_get_session(ec, deadline);
+        origin = fallback;
+    }
+    if (session) {
+        remember_origin(*session, origin);
+    }
+    return session;
+}
+
+template <typename Connector, typename Strategy, typename Storage>
+void sharded_connection_pool<Connector, Strategy, Storage>::return_session(std::unique_ptr<stream_type>&& session)
+{
+    if (!session) {
+        return;
+    }
+
+    boost::system::error_code peer_ec;
+    const auto peer = session->lowest_layer().remote_endpoint(peer_ec);
+    if (peer_ec) {
+        // a session without a remote endpoint is dead anyway, nowhere to route it
+        return;
+    }
+
+    std::size_t origin = 0;
+    bool known = false;
+    {
+        std::lock_guard<std::mutex> lk(origins_mutex_);
+        auto origin_it = session_origins_.find(peer);
+        if (origin_it != session_origins_.end()) {
+            origin = origin_it->second;
+            known = true;
+        }
+    }
+    if (!known) {
+        // not drawn from this pool, its upstream is unknown - drop it
+        STREAM_LOG_INFO("sharded_connection_pool has dropped a foreign session on return");
+        return;
+    }
+    shards_[origin]->return_session(std::move(session));
+}
+
+template <typename Connector, typename Strategy, typename Storage>
+bool sharded_connection_pool<Connector, Strategy, Storage>::is_connected(boost::system::error_code& ec,
+                                                                         const time_point_type& deadline) const
+{
+    do {
+        for (const auto& shard : shards_) {
+            boost::system::error_code shard_ec;
+            if (shard->is_connected(shard_ec, clock_type::now())) {
+                ec = boost::system::error_code();
+                return true;
+            }
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    } while (clock_type::now() < deadline);
+
+    ec = boost::asio::error::timed_out;
+    return false;
+}
+
+template <typename Connector, typename Strategy, typename Storage>
+std::pair<std::size_t, std::size_t> sharded_connection_pool<Connector, Strategy, Storage>::pick_two() const
+{
+    if (shards_.size() == 1) {
+        return {0, 0};
+    }
+    thread_local std::minstd_rand generator{std::random_device{}()};
+    std::uniform_int_distribution<std::size_t> distribution(0, shards_.size() - 1);
+    const std::size_t first = distribution(generator);
+    std::size_t second = distribution(generator);
+    if (second == first) {
+        second = (second + 1) % shards_.size();
+    }
+    return {first, second};
+}
+
+template <typename Connector, typename Strategy, typename Storage>
+bool sharded_connection_pool<Connector, Strategy, Storage>::better_shard(std::size_t lhs, std::size_t rhs) const
+{
+    const auto lhs_stats = shards_[lhs]->get_metrics().snapshot();
+    const auto rhs_stats = shards_[rhs]->get_metrics().snapshot();
+
+    // occupancy first: the fuller shard has spare capacity and a healthy upstream
+    if (lhs_stats.current_size != rhs_stats.current_size) {
+        return lhs_stats.current_size > rhs_stats.current_size;
+    }
+    // equal occupancy: prefer the shard whose pulls have waited less on average
+    const auto lhs_wait = (lhs_stats.acquires > 0) ? lhs_stats.acquire_wait_ns / lhs_stats.acquires : 0;
+    const auto rhs_wait = (rhs_stats.acquires > 0) ? rhs_stats.acquire_wait_ns / rhs_stats.acquires : 0;
+    return lhs_wait <= rhs_wait;
+}
+
+template <typename Connector, typename Strategy, typename Storage>
+void sharded_connection_pool<Connector, Strategy, Storage>::remember_origin(const stream_type& session,
+                                                                            std::size_t shard)
+{
+    boost::system::error_code peer_ec;
+    const auto peer = session.lowest_layer().remote_endpoint(peer_ec);
+    if (peer_ec) {
+        // the session died right after the pull; it won't be routable on return either
+        return;
+    }
+    // the endpoint set is bounded by what the shards' connectors resolve, so the map
+    // stays small and entries need no cleanup when sessions are dropped mid-flight
+    std::lock_guard<std::mutex> lk(origins_mutex_);
+    session_origins_[peer] = shard;
+}
+
+} // namespace connector
+} // namespace stream_client
@@ -0,0 +1,198 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+
+namespace stream_client {
+namespace connector {
+
+/**
+ * Point-in-time copy of pool counters, see pool_metrics::snapshot().
+ * Latency counters come as total nanoseconds plus event count, so scrapers can
+ * derive averages and rates between two snapshots.
+ */
+struct pool_metrics_snapshot
+{
+    std::uint64_t acquires; ///< Sessions successfully pulled via get_session()/try_get_session().
+    std::uint64_t acquire_misses; ///< Pulls that failed (empty pool, timeout).
+    std::uint64_t acquire_wait_ns; ///< Total time spent waiting inside pulls.
+    std::uint64_t returns; ///< Alive sessions accepted back by return_session().
+    std::uint64_t dropped_returns; ///< Alive sessions dropped on return due to storage contention.
+    std::uint64_t refills; ///< Refill rounds executed by the watcher.
+    std::uint64_t refill_ns; ///< Total time spent in refill rounds.
+    std::uint64_t idle_evictions; ///< Sessions removed by the idle-timeout sweep.
+    std::uint64_t dead_evictions; ///< Peer-closed sessions removed by liveness screening.
+    std::uint64_t current_size; ///< Sessions in the pool as of the last watcher sweep.
+};
+
+/**
+ * Hot-path counters maintained by base_connection_pool.
+ * All updates are relaxed atomic increments, so recording costs a few
+ * uncontended RMW operations; reading is done via snapshot().
+ *
+ * @note Thread-safe.
+ */
+class pool_metrics
+{
+public:
+    /// Record a session pull: @p hit tells if a session was obtained, @p wait_ns how long the call waited.
+    void record_acquire(bool hit, std::uint64_t wait_ns)
+    {
+        if (hit) {
+            acquires_.fetch_add(1, std::memory_order_relaxed);
+        } else {
+            acquire_misses_.fetch_add(1, std::memory_order_relaxed);
+        }
+        acquire_wait_ns_.fetch_add(wait_ns, std::memory_order_relaxed);
+    }
+
+    /// Record an alive session coming back; @p dropped tells if the storage rejected it.
+    void record_return(bool dropped)
+    {
+        if (dropped) {
+            dropped_returns_.fetch_add(1, std::memory_order_relaxed);
+        } else {
+            returns_.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+
+    /// Record a refill round which took @p duration_ns.
+    void record_refill(std::uint64_t duration_ns)
+    {
+        refills_.fetch_add(1, std::memory_order_relaxed);
+        refill_ns_.fetch_add(duration_ns, std::memory_order_relaxed);
+    }
+
+    /// Record @p count sessions evicted by the idle-timeout sweep.
+    void record_idle_evictions(std::uint64_t count)
+    {
+        idle_evictions_.fetch_add(count, std::memory_order_relaxed);
+    }
+
+    /// Record @p count peer-closed sessions dropped by liveness screening.
+    void record_dead_evictions(std::uint64_t count)
+    {
+        dead_evictions_.fetch_add(count, std::memory_order_relaxed);
+    }
+
+    /// Record the pool size observed by the watcher.
+    void record_size(std::uint64_t size)
+    {
+        current_size_.store(size, std::memory_order_relaxed);
+    }
+
+    /**
+     * Take a consistent-enough copy of all counters.
+     * Counters are loaded individually, so a snapshot taken concurrently with
+     * updates may be off by in-flight increments; fine for scraping.
+     *
+     * @returns Copy of the counters.
+     */
+    pool_metrics_snapshot snapshot() const
+    {
+        pool_metrics_snapshot copy;
+        copy.acquires = acquires_.load(std::memory_order_relaxed);
+        copy.acquire_misses = acquire_misses_.load(std::memory_order_relaxed);
+        copy.acquire_wait_ns = acquire_wait_ns_.load(std::memory_order_relaxed);
+        copy.returns = returns_.load(std::memory_order_relaxed);
+        copy.dropped_returns = dropped_returns_.load(std::memory_order_relaxed);
+        copy.refills = refills_.load(std::memory_order_relaxed);
+        copy.refill_ns = refill_ns_.load(std::memory_order_relaxed);
+        copy.idle_evictions = idle_evictions_.load(std::memory_order_relaxed);
+        copy.dead_evictions = dead_evictions_.load(std::memory_order_relaxed);
+        copy.current_size = current_size_.load(std::memory_order_relaxed);
+        return copy;
+    }
+
+private:
+    std::atomic<std::uint64_t> acquires_{0};
+    std::atomic<std::uint64_t> acquire_misses_{0};
+    std::atomic<std::uint64_t> acquire_wait_ns_{0};
+    std::atomic<std::uint64_t> returns_{0};
+    std::atomic<std::uint64_t> dropped_returns_{0};
+    std::atomic<std::uint64_t> refills_{0};
+    std::atomic<std::uint64_t> refill_ns_{0};
+    std::atomic<std::uint64_t> idle_evictions_{0};
+    std::atomic<std::uint64_t> dead_evictions_{0};
+    std::atomic<std::uint64_t> current_size_{0};
+};
+
+/**
+ * Point-in-time copy of connector counters, see connector_metrics::snapshot().
+ */
+struct connector_metrics_snapshot
+{
+    std::uint64_t connects; ///< Sessions successfully established by new_session().
+    std::uint64_t connect_failures; ///< new_session() calls that failed.
+    std::uint64_t connect_ns; ///< Total time spent establishing sessions.
+    std::uint64_t resolves; ///< Successful DNS resolutions.
+    std::uint64_t resolve_failures; ///< Failed DNS resolutions.
+};
+
+/**
+ * Hot-path counters maintained by base_connector. Same cost model as pool_metrics.
+ *
+ * @note Thread-safe.
+ */
+class connector_metrics
+{
+public:
+    /// Record a new_session() outcome which took @p duration_ns.
+    void record_connect(bool success, std::uint64_t duration_ns)
+    {
+        if (success) {
+            connects_.fetch_add(1, std::memory_order_relaxed);
+        } else {
+            connect_failures_.fetch_add(1, std::memory_order_relaxed);
+        }
+        connect_ns_.fetch_add(duration_ns, std::memory_order_relaxed);
+    }
+
+    /// Record a DNS resolution outcome.
+    void record_resolve(bool success)
+    {
+        if (success) {
+            resolves_.fetch_add(1, std::memory_order_relaxed);
+        } else {
+            resolve_failures_.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+
+    /**
+     * Take a copy of all counters; same consistency caveats as pool_metrics::snapshot().
+     *
+     * @returns Copy of the counters.
+     */
+    connector_metrics_snapshot snapshot() const
+    {
+        connector_metrics_snapshot copy;
+        copy.connects = connects_.load(std::memory_order_relaxed);
+        copy.connect_failures = connect_failures_.load(std::memory_order_relaxed);
+        copy.connect_ns = connect_ns_.load(std::memory_order_relaxed);
+        copy.resolves = resolves_.load(std::memory_order_relaxed);
+        copy.resolve_failures = resolve_failures_.load(std::memory_order_relaxed);
+        return copy;
+    }
+
+private:
+    std::atomic<std::uint64_t> connects_{0};
+    std::atomic<std::uint64_t> connect_failures_{0};
+    std::atomic<std::uint64_t> connect_ns_{0};
+    std::atomic<std::uint64_t> resolves_{0};
+    std::atomic<std::uint64_t> resolve_failures_{0};
+};
+
+namespace detail {
+
+/// Nanoseconds elapsed between two time points of any steady clock.
+template <typename TimePoint>
+inline std::uint64_t elapsed_ns(const TimePoint& from, const TimePoint& to)
+{
+    return static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(to - from).count());
+}
+
+} // namespace detail
+
+} // namespace connector
+} // namespace stream_client
@@ -0,0 +1,247 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <type_traits>
+#include <utility>
+
+#include <boost/system/error_code.hpp>
+
+namespace stream_client {
+namespace connector {
+
+/**
+ * Order in which stored sessions are reused by the pool.
+ */
+enum class pool_reuse_order
+{
+    /// Oldest-returned first. Spreads traffic evenly, every session stays just-alive.
+    fifo,
+    /// Most-recently-returned first. Concentrates traffic on a warm subset (kernel buffers,
+    /// TCP congestion window and TLS state still hot) and lets the surplus hit idle_timeout.
+    lifo,
+};
+
+/**
+ * Default session storage for connection_pool. Used by base_connection_pool to keep established sessions.
+ *
+ * Stores sessions in std::list guarded with single std::timed_mutex. Simple and
+ * memory-friendly, but get/put operations of concurrent threads serialize on the mutex.
+ *
+ * @note Thread-safe. Single instance support concurrent operation.
+ *
+ * @tparam Connector Type of connector the pool is instantiated with.
+ */
+template <typename Connector>
+class list_pool_storage
+{
+public:
+    using connector_type = typename std::remove_reference<Connector>::type;
+    using stream_type = typename connector_type::stream_type;
+
+    using clock_type = typename connector_type::clock_type;
+    using time_duration_type = typename connector_type::time_duration_type;
+    using time_point_type = typename connector_type::time_point_type;
+
+    /**
+     * Parametrized constructor.
+     *
+     * @param[in] size Number of sessions the owning pool maintains. Unused, the list is unbounded.
+     * @param[in] reuse_order Order in which stored sessions are reused, see pool_reuse_order.
+     */
+    list_pool_storage(std::size_t size, pool_reuse_order reuse_order = pool_reuse_order::fifo);
+
+    /// Copy constructor is not permitted.
+    list_pool_storage(const list_pool_storage<Connector>& other) = delete;
+    /// Copy assignment is not permitted.
+    list_pool_storage<Connector>& operator=(const list_pool_storage<Connector>& other) = delete;
+
+    /**
+     * Pull a stored session (oldest for fifo order, most recently returned for lifo).
+     * Waits until @p deadline for a session to appear.
+     *
+     * @param[out] ec Set to boost::asio::error::timed_out if failed to lock the storage;
+     *      set to boost::asio::error::not_found if it is still empty past the deadline.
+     * @param[in] deadline Expiration time-point.
+     *
+     * @returns A stream wrapped in std::unique_ptr or nullptr.
+     */
+    std::unique_ptr<stream_type> get(boost::system::error_code& ec, const time_point_type& deadline);
+
+    /**
+     * Pull a stored session (oldest for fifo order, most recently returned for lifo)
+     * without waiting for a non-empty storage.
+     *
+     * @param[out] ec Set to boost::asio::error::timed_out if failed to lock the storage;
+     *      set to boost::asio::error::not_found if it is empty.
+     * @param[in] deadline Expiration time-point, bounds lock acquisition only.
+     *
+     * @returns A stream wrapped in std::unique_ptr or nullptr.
+     */
+    std::unique_ptr<stream_type> try_get(boost::system::error_code& ec, const time_point_type& deadline);
+
+    /**
+     * Store a session.
+     *
+     * @param[in] added Time-point the session is added at, used for idle tracking.
+     * @param[in] session Session to store.
+     *
+     * @returns false if the session has been dropped because of lock contention.
+     */
+    bool put(const time_point_type& added, std::unique_ptr<stream_type>&& session);
+
+    /**
+     * Wait until the storage has at least one session.
+     *
+     * @param[out] ec Set to boost::asio::error::timed_out if failed to lock the storage;
+     *      set to boost::asio::error::not_found if it is still empty past the deadline.
+     * @param[in] deadline Expiration time-point.
+     *
+     * @returns true - if storage is not empty; false - if it is empty or deadline reached.
+     */
+    bool wait_for_session(boost::system::error_code& ec, const time_point_type& deadline) const;
+
+    /// Number of stored sessions.
+    inline std::size_t size() const
+    {
+        std::lock_guard<std::timed_mutex> lock(mutex_);
+        return sessions_.size();
+    }
+
+    /**
+     * Remove sessions stored for longer than @p idle_timeout.
+     *
+     * @param[in] now Current time-point.
+     * @param[in] idle_timeout Idle timeout for stored sessions.
+     * @param[out] remaining Number of sessions left after the removal.
+     * @param[out] removed Number of sessions evicted.
+     * @param[out] oldest Add-time of the oldest remaining session, lets the caller schedule
+     *      the next expiry instead of rediscovering it by sweeping; time_point_type::max() if empty.
+     *
+     * @returns false if failed to lock the storage, output parameters are left untouched.
+     */
+    bool remove_idle(const time_point_type& now, const time_duration_type& idle_timeout, std::size_t& remaining,
+                     std::size_t& removed, time_point_type& oldest);
+
+    /**
+     * Remove sessions for which @p is_alive returns false, keeping idle timestamps of the rest intact.
+     *
+     * @param[in] is_alive Predicate to screen stored sessions with.
+     * @param[out] removed Number of sessions evicted.
+     *
+     * @returns false if failed to lock the storage, @p removed is left untouched.
+     */
+    bool remove_dead(const std::function<bool(stream_type&)>& is_alive, std::size_t& removed);
+
+private:
+    /// Pop a session according to @p reuse_order_. Call under the lock on non-empty @p sessions_.
+    std::unique_ptr<stream_type> pop_session();
+
+    std::list<std::pair<time_point_type, std::unique_ptr<stream_type>>> sessions_; ///< The list of stored sessions.
+    pool_reuse_order reuse_order_; ///< Which end of @p sessions_ get() pops from.
+    mutable std::timed_mutex mutex_; ///< @p sessions_ mutex.
+    mutable std::condition_variable_any cv_; ///< @p sessions_ condition variable.
+};
+
+/**
+ * Lock-free session storage for connection_pool.
+ *
+ * Keeps sessions in a bounded MPMC ring-buffer (D. Vyukov design): get/put of
+ * concurrent threads are a couple of atomic operations and never serialize on a
+ * mutex, so returned sessions are never dropped because of lock contention.
+ * The internal mutex is used only to park threads waiting on empty storage.
+ *
+ * Capacity is fixed at twice the pool size (rounded up to a power of two), which
+ * accommodates the pool refilling itself while pulled sessions are still in flight.
+ *
+ * @note Thread-safe. Single instance support concurrent operation.
+ *
+ * @tparam Connector Type of connector the pool is instantiated with.
+ */
+template <typename Connector>
+class mpmc_pool_storage
+{
+public:
+    using connector_type = typename std::remove_reference<Connector>::type;
+    using stream_type = typename connector_type::stream_type;
+
+    using clock_type = typename connector_type::clock_type;
+    using time_duration_type = typename connector_type::time_duration_type;
+    using time_point_type = typename connector_type::time_point_type;
+
+    /**
+     * Parametrized constructor.
+     *
+     * @param[in] size Number of sessions the owning pool maintains.
+     * @param[in] reuse_order Order in which stored sessions are reused. The ring is inherently
+     *      FIFO, so only pool_reuse_order::fifo is supported.
+     *
+     * @throws std::runtime_error if @p reuse_order is not pool_reuse_order::fifo.
+     */
+    mpmc_pool_storage(std::size_t size, pool_reuse_order reuse_order = pool_reuse_order::fifo);
+
+    /// Copy constructor is not permitted.
+    mpmc_pool_storage(const mpmc_pool_storage<Connector>& other) = delete;
+    /// Copy assignment is not permitted.
+    mpmc_pool_storage<Connector>& operator=(const mpmc_pool_storage<Connector>& other) = delete;
+
+    /// Pull the oldest stored session. Waits until @p deadline for a session to appear.
+    std::unique_ptr<stream_type> get(boost::system::error_code& ec, const time_point_type& deadline);
+
+    /// Pull the oldest stored session without waiting for a non-empty storage.
+    std::unique_ptr<stream_type> try_get(boost::system::error_code& ec, const time_point_type& deadline);
+
+    /// Store a session; @returns false if the session has been dropped because the ring is full.
+    bool put(const time_point_type& added, std::unique_ptr<stream_type>&& session);
+
+    /// Wait until the storage has at least one session.
+    bool wait_for_session(boost::system::error_code& ec, const time_point_type& deadline) const;
+
+    /// Approximate number of stored sessions.
+    inline std::size_t size() const
+    {
+        const std::size_t tail = enqueue_pos_.load(std::memory_order_acquire);
+        const std::size_t head = dequeue_pos_.load(std::memory_order_acquire);
+        return (tail > head) ? tail - head : 0;
+    }
+
+    /// Remove sessions stored for longer than @p idle_timeout; reports add-time of the oldest
+    /// remaining session via @p oldest (time_point_type::max() if empty); never fails.
+    bool remove_idle(const time_point_type& now, const time_duration_type& idle_timeout, std::size_t& remaining,
+                     std::size_t& removed, time_point_type& oldest);
+
+    /// Remove sessions for which @p is_alive returns false, keeping idle timestamps intact; never fails.
+    bool remove_dead(const std::function<bool(stream_type&)>& is_alive, std::size_t& removed);
+
+private:
+    using item_type = std::pair<time_point_type, std::unique_ptr<stream_type>>;
+
+    /// Single ring-buffer slot with its' sequence number.
+    struct cell_type
+    {
+        std::atomic<std::size_t> sequence;
+        item_type item;
+    };
+
+    /// Enqueue @p item into the ring; @returns false if the ring is full.
+    bool try_enqueue(item_type&& item);
+    /// Dequeue the oldest item from the ring; @returns false if the ring is empty.
+    bool try_dequeue(item_type& item);
+
+    std::unique_ptr<cell_type[]> cells_; ///< Ring buffer of sessions.
+    std::size_t mask_; ///< Ring size - 1, for cheap modulo.
+    std::atomic<std::size_t> enqueue_pos_{0}; ///< Ticket of the next put().
+    std::atomic<std::size_t> dequeue_pos_{0}; ///< Ticket of the next get().
+
+    mutable std::mutex wait_mutex_; ///< Used only to park threads waiting on empty storage.
+    mutable std::condition_variable wait_cv_; ///< Notified by put().
+};
+
+} // namespace connector
+} // namespace stream_client
+
+#include "impl/pool_storage.ipp"
@@ -1,5 +1,8 @@
 #pragma once
 
+#include "connect_engine.hpp"
+#include "pool_metrics.hpp"
+
 #include <functional>
 #include <memory>
 #include <random>
@@ -32,10 +35,26 @@ public:
      * @returns true if all session have been successfully added.
      */
     virtual bool refill(connector_type& connector, std::size_t vacant_places, append_func_type append_func) = 0;
+
+    /**
+     * Number of sessions the pool should maintain right now.
+     * Called by the pool watcher each sweep; default keeps the configured size.
+     * Adaptive strategies may override this to scale within bounds based on @p metrics.
+     *
+     * @param configured_size Pool size set at construction.
+     * @param metrics Live pool counters to judge demand by.
+     *
+     * @returns Desired number of sessions.
+     */
+    virtual std::size_t target_size(std::size_t configured_size, const pool_metrics& metrics)
+    {
+        (void)metrics;
+        return configured_size;
+    }
 };
 
 /**
- * Greedy strategy. Will refill pool completely using multiple threads.
+ * Greedy strategy. Will refill pool completely using a persistent connect engine.
  */
 template <typename Connector>
 class greedy_strategy: public pool_strategy<Connector>
@@ -60,6 +79,9 @@ public:
      * @returns true if @p vacant_places > 0.
      */
     virtual bool refill(connector_type& connector, std::size_t vacant_places, append_func_type append_func) override;
+
+private:
+    detail::connect_engine engine_; ///< Persistent workers running connect jobs.
 };
 
 /**
@@ -112,6 +134,8 @@ public:
     virtual bool refill(connector_type& connector, std::size_t vacant_places, append_func_type append_func) override;
 
 private:
+    detail::connect_engine engine_; ///< Persistent workers running connect jobs.
+
     time_point_type wait_until_;
     unsigned long initial_delay_ms_;
     unsigned long delay_multiplier_;
@@ -121,6 +145,72 @@ private:
     std::mt19937 r_generator_;
 };
 
+/**
+ * Demand-adaptive strategy. Refills like greedy_strategy but scales the pool
+ * target between a min and max bound based on observed demand: misses, long
+ * acquire waits or a sharp rise of the acquire rate grow the target, sustained
+ * low per-session utilization shrinks it. This frees upstream connection slots
+ * at night and avoids pointless evict/re-handshake cycles of idle sessions.
+ */
+template <typename Connector>
+class adaptive_strategy: public greedy_strategy<Connector>
+{
+public:
+    using connector_type = typename pool_strategy<Connector>::connector_type;
+    using stream_type = typename pool_strategy<Connector>::stream_type;
+    using append_func_type = typename pool_strategy<Connector>::append_func_type;
+
+    using clock_type = typename connector_type::clock_type;
+    using time_duration_type = typename connector_type::time_duration_type;
+    using time_point_type = typename connector_type::time_point_type;
+
+    /// Period between target re-evaluations in ms.
+    static const unsigned long kEvalPeriodMs;
+    /// Average acquire wait that is considered starvation, in ns.
+    static const unsigned long kGrowWaitThresholdNs;
+
+    /**
+     * Creates adaptive strategy with default bounds derived from the configured
+     * pool size on first use: max = configured size, min = 1/10 of it (at least 1).
+     */
+    adaptive_strategy() = default;
+
+    /**
+     * Creates adaptive strategy with explicit bounds.
+     *
+     * @param min_size Lower bound for the pool target.
+     * @param max_size Upper bound for the pool target.
+     */
+    adaptive_strategy(std::size_t min_size, std::size_t max_size);
+
+    /// Destructor.
+    virtual ~adaptive_strategy() = default;
+
+    /**
+     * Re-evaluates the desired pool size at most once per kEvalPeriodMs.
+     *
+     * Growth: any miss, average wait above kGrowWaitThresholdNs, or the acquire
+     * rate doubling since the last evaluation adds half of the current target.
+     * Shrink: less than one acquire per pooled session per second removes a
+     * tenth of the current target. The result is clamped to [min, max].
+     *
+     * @param configured_size Pool size set at construction.
+     * @param metrics Live pool counters to judge demand by.
+     *
+     * @returns Desired number of sessions.
+     */
+    virtual std::size_t target_size(std::size_t configured_size, const pool_metrics& metrics) override;
+
+private:
+    std::size_t min_size_{0}; ///< Lower target bound; 0 means derive from configured size.
+    std::size_t max_size_{0}; ///< Upper target bound; 0 means derive from configured size.
+    std::size_t current_target_{0}; ///< Last computed target; 0 until first evaluation.
+
+    time_point_type next_eval_{}; ///< Next time the target is re-evaluated.
+    pool_metrics_snapshot last_stats_{}; ///< Counters as of the last evaluation.
+    double last_rate_{0.0}; ///< Acquire rate observed at the last evaluation.
+};
+
 } // namespace connector
 } // namespace stream_client
 
@@ -0,0 +1,321 @@
+#pragma once
+
+#include "connection_pool.hpp"
+
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace stream_client {
+namespace connector {
+
+/**
+ * Pool of connected sockets spread over multiple upstream endpoints.
+ *
+ * This class owns one base_connection_pool (shard) per passed endpoint and balances
+ * get_session() across them with power-of-two-choices: two shards are picked at
+ * random and the session is drawn from the one with better observed occupancy and
+ * acquire latency. A slow or dead node drains its shard and stops winning the
+ * comparison, so traffic shifts away from it automatically; once the node recovers
+ * its shard refills and starts winning again. Sessions returned with
+ * return_session() go back to the shard they were drawn from.
+ *
+ * @note Thread-safe. Single instance support concurrent operation.
+ *
+ * @tparam Connector Type of connector to use to create sockets.
+ * @tparam Strategy Type of reconnection strategy. For more info look in pool_strategy.hpp.
+ * @tparam Storage Type of session storage. For more info look in pool_storage.hpp.
+ */
+template <typename Connector, typename Strategy = greedy_strategy<Connector>,
+          typename Storage = list_pool_storage<Connector>>
+class sharded_connection_pool
+{
+public:
+    using shard_pool_type = base_connection_pool<Connector, Strategy, Storage>;
+    using connector_type = typename shard_pool_type::connector_type;
+    using stream_type = typename shard_pool_type::stream_type;
+    using protocol_type = typename shard_pool_type::protocol_type;
+
+    using session_endpoint_type = typename stream_type::endpoint_type;
+
+    using clock_type = typename shard_pool_type::clock_type;
+    using time_duration_type = typename shard_pool_type::time_duration_type;
+    using time_point_type = typename shard_pool_type::time_point_type;
+
+    /// Host plus port of a single upstream endpoint.
+    using endpoint_type = std::pair<std::string, std::string>;
+
+    /**
+     * Parametrized constructor.
+     * Constructs a shard (its connector plus session storage) per endpoint; @p argn are
+     * passed to every @p Connector constructor after the endpoint's host and port.
+     *
+     * @tparam ...ArgN Types of argn.
+     *
+     * @param[in] size Number of connected sockets to maintain in each shard.
+     * @param[in] idle_timeout Sessions idling in a shard for longer are replaced with new ones.
+     * @param[in] endpoints Upstream endpoints, one shard per entry. Must not be empty.
+     * @param[in] ...argn Arguments to pass to each @p Connector constructor.
+     *
+     * @throws std::runtime_error If @p endpoints is empty.
+     */
+    template <typename... ArgN>
+    sharded_connection_pool(std::size_t size, time_duration_type idle_timeout,
+                            const std::vector<endpoint_type>& endpoints, ArgN&&... argn);
+
+    /**
+     * Parametrized constructor.
+     * Same as above but without idle timeout, sessions are reused forever.
+     *
+     * @tparam ...ArgN Types of argn.
+     *
+     * @param[in] size Number of connected sockets to maintain in each shard.
+     * @param[in] endpoints Upstream endpoints, one shard per entry. Must not be empty.
+     * @param[in] ...argn Arguments to pass to each @p Connector constructor.
+     *
+     * @throws std::runtime_error If @p endpoints is empty.
+     */
+    template <typename... ArgN>
+    sharded_connection_pool(std::size_t size, const std::vector<endpoint_type>& endpoints, ArgN&&... argn);
+
+    /// Copy constructor is not permitted.
+    sharded_connection_pool(const sharded_connection_pool<Connector, Strategy, Storage>& other) = delete;
+    /// Copy assignment is not permitted.
+    sharded_connection_pool<Connector, Strategy, Storage>&
+    operator=(const sharded_connection_pool<Connector, Strategy, Storage>& other) = delete;
+    /// Move constructor is not permitted.
+    sharded_connection_pool(sharded_connection_pool<Connector, Strategy, Storage>&& other) = delete;
+    /// Move assignment is not permitted.
+    sharded_connection_pool<Connector, Strategy, Storage>&
+    operator=(sharded_connection_pool<Connector, Strategy, Storage>&& other) = delete;
+
+    /// Destructor.
+    virtual ~sharded_connection_pool() = default;
+
+    /**
+     * Pull a session (stream) from one of the shards.
+     * Two shards are picked at random and the fuller/faster one is tried first;
+     * if both are empty the call falls back to a blocking pull from the better
+     * shard until the specified deadline is reached.
+     *
+     * @param[in] deadline Expiration time-point.
+     * @param[out] ec Set to indicate what error occurred, if any.
+     *
+     * @returns A stream wrapped in std::unique_ptr or nullptr.
+     */
+    std::unique_ptr<stream_type> get_session(boost::system::error_code& ec, const time_point_type& deadline);
+
+    /**
+     * Pull a session (stream) from one of the shards.
+     * Same as above with the deadline derived from specified timeout.
+     *
+     * @param[in] timeout Expiration duration.
+     * @param[out] ec Set to indicate what error occurred, if any.
+     *
+     * @returns A stream wrapped in std::unique_ptr or nullptr.
+     */
+    inline std::unique_ptr<stream_type> get_session(boost::system::error_code& ec, const time_duration_type& timeout)
+    {
+        return get_session(ec, clock_type::now() + timeout);
+    }
+
+    /**
+     * Pull a session (stream) from one of the shards.
+     * Timeout for this operation is defined by default connection timeout
+     * (returned by get_connect_timeout).
+     *
+     * @param[out] ec Set to indicate what error occurred, if any.
+     *
+     * @returns A stream wrapped in std::unique_ptr or nullptr.
+     */
+    inline std::unique_ptr<stream_type> get_session(boost::system::error_code& ec)
+    {
+        return get_session(ec, get_connect_timeout());
+    }
+
+    /**
+     * Pull a session (stream) from one of the shards.
+     *
+     * @param[in] timeout_or_deadline Expiration time-point or duration.
+     *
+     * @returns A stream wrapped in std::unique_ptr. Guaranteed to return valid pointer.
+     * @throws boost::system::system_error Thrown on failure.
+     */
+    template <typename Time>
+    inline std::unique_ptr<stream_type> get_session(const Time& timeout_or_deadline)
+    {
+        boost::system::error_code ec;
+        auto session = get_session(ec, timeout_or_deadline);
+        if (ec) {
+            throw boost::system::system_error{ec, "Failed to get a session from the sharded pool"};
+        }
+        if (!session) {
+            throw boost::system::system_error{boost::asio::error::operation_aborted,
+                                              "Failed to get a session from the sharded pool"};
+        }
+        return session;
+    }
+
+    /**
+     * Pull a session (stream) from one of the shards.
+     * Timeout for this operation is defined by default connection timeout
+     * (returned by get_connect_timeout).
+     *
+     * @returns A stream wrapped in std::unique_ptr. Guaranteed to return valid pointer.
+     * @throws boost::system::system_error Thrown on failure.
+     */
+    inline std::unique_ptr<stream_type> get_session()
+    {
+        return get_session(get_connect_timeout());
+    }
+
+    /**
+     * Try to pull a session (stream) from one of the shards.
+     * Two shards are picked at random and both are tried without waiting for a refill.
+     *
+     * @param[in] deadline Expiration time-point.
+     * @param[out] ec Set to indicate what error occurred, if any.
+     *
+     * @returns A stream wrapped in std::unique_ptr or nullptr.
+     */
+    std::unique_ptr<stream_type> try_get_session(boost::system::error_code& ec, const time_point_type& deadline);
+
+    /**
+     * Try to pull a session (stream) from one of the shards.
+     * Same as above with the deadline derived from specified timeout.
+     *
+     * @param[in] timeout Expiration duration.
+     * @param[out] ec Set to indicate what error occurred, if any.
+     *
+     * @returns A stream wrapped in std::unique_ptr or nullptr.
+     */
+    inline std::unique_ptr<stream_type> try_get_session(boost::system::error_code& ec,
+                                                        const time_duration_type& timeout)
+    {
+        return try_get_session(ec, clock_type::now() + timeout);
+    }
+
+    /**
+     * Return the session pulled earlier from this pool.
+     * The session is routed back to its owning shard by its remote endpoint; sessions
+     * whose endpoint is not known to this pool are dropped.
+     *
+     * @remark Return session only if you don't expect incoming data to appear or handle such cases by yourself.
+     */
+    void return_session(std::unique_ptr<stream_type>&& session);
+
+    /**
+     * Check if at least one shard has a stream ready.
+     * Polls the shards until @p deadline.
+     *
+     * @param[in] deadline Expiration time-point.
+     * @param[out] ec Set to boost::asio::error::timed_out if no shard became non-empty in time.
+     *
+     * @returns true - if some shard is not empty; false otherwise.
+     */
+    bool is_connected(boost::system::error_code& ec, const time_point_type& deadline) const;
+
+    /**
+     * Check if at least one shard has a stream ready.
+     * Polls the shards for @p timeout.
+     *
+     * @param[in] timeout Expiration duration.
+     * @param[out] ec Set to boost::asio::error::timed_out if no shard became non-empty in time.
+     *
+     * @returns true - if some shard is not empty; false otherwise.
+     */
+    inline bool is_connected(boost::system::error_code& ec, const time_duration_type& timeout) const
+    {
+        return is_connected(ec, clock_type::now() + timeout);
+    }
+
+    /**
+     * Check if at least one shard has a stream ready.
+     * Timeout for this operation is defined by default connection timeout
+     * (returned by get_connect_timeout).
+     *
+     * @param[out] ec Set to boost::asio::error::timed_out if no shard became non-empty in time.
+     *
+     * @returns true - if some shard is not empty; false otherwise.
+     */
+    inline bool is_connected(boost::system::error_code& ec) const
+    {
+        return is_connected(ec, clock_type::now() + get_connect_timeout());
+    }
+
+    /// Get number of shards (endpoints) in this pool.
+    inline std::size_t shard_count() const
+    {
+        return shards_.size();
+    }
+
+    /**
+     * Get connect operations default timeout; all shards share the same value.
+     *
+     * @returns A const reference to the timeout.
+     */
+    inline const time_duration_type& get_connect_timeout() const
+    {
+        return shards_.front()->get_connect_timeout();
+    }
+
+    /**
+     * Get hot-path counters of a single shard.
+     * Use pool_metrics::snapshot() on the result to scrape them.
+     *
+     * @param[in] shard Index of the shard, [0, shard_count()).
+     *
+     * @returns A const reference to the live counters.
+     */
+    inline const pool_metrics& get_metrics(std::size_t shard) const
+    {
+        return shards_.at(shard)->get_metrics();
+    }
+
+    /**
+     * Get connect/resolve counters of a single shard's connector.
+     * Use connector_metrics::snapshot() on the result to scrape them.
+     *
+     * @param[in] shard Index of the shard, [0, shard_count()).
+     *
+     * @returns A const reference to the live counters.
+     */
+    inline const connector_metrics& get_connector_metrics(std::size_t shard) const
+    {
+        return shards_.at(shard)->get_connector_metrics();
+    }
+
+private:
+    /// Pick two distinct random shard indices; both equal if there is a single shard.
+    std::pair<std::size_t, std::size_t> pick_two() const;
+
+    /// Tell if shard @p lhs looks like a better source than @p rhs: fuller first, then faster.
+    bool better_shard(std::size_t lhs, std::size_t rhs) const;
+
+    /// Remember which shard serves @p session's remote endpoint so return_session() can route it back.
+    /// Keyed by endpoint rather than session address: sessions may be dropped instead of
+    /// returned, and a recycled heap address must not route a session into a foreign shard.
+    void remember_origin(const stream_type& session, std::size_t shard);
+
+    std::vector<std::unique_ptr<shard_pool_type>> shards_; ///< Sub-pool per endpoint.
+
+    std::map<session_endpoint_type, std::size_t> session_origins_; ///< Shard index per observed remote endpoint.
+    mutable std::mutex origins_mutex_; ///< Guards @p session_origins_.
+};
+
+//! Sharded connections pool with sockets over plain TCP protocol.
+using tcp_sharded_pool = sharded_connection_pool<tcp_connector>;
+//! Sharded connections pool with sockets over plain UDP protocol.
+using udp_sharded_pool = sharded_connection_pool<udp_connector>;
+//! Sharded connections pool with sockets over encrypted TCP protocol.
+using ssl_sharded_pool = sharded_connection_pool<ssl_connector>;
+//! Sharded connections pool with sockets over HTTP protocol.
+using http_sharded_pool = sharded_connection_pool<http_connector>;
+//! Sharded connections pool with sockets over HTTPS protocol.
+using https_sharded_pool = sharded_connection_pool<https_connector>;
+
+} // namespace connector
+} // namespace stream_client
+
+#include "impl/sharded_connection_pool.ipp"
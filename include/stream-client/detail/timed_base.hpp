@@ -1,10 +1,14 @@
 #pragma once
 
+#include "stream-client/reactor.hpp"
+
 #include <boost/asio/basic_waitable_timer.hpp>
 #include <boost/asio/io_service.hpp>
 
 #include <chrono>
+#include <condition_variable>
 #include <iostream>
+#include <mutex>
 
 namespace stream_client {
 namespace detail {
@@ -13,10 +17,13 @@ namespace detail {
  * Base class with timeout handling.
  *
  * This class implements basic setup/reset for internal timer instance.
- * Instances of this class own boost::asio::io_service and boost::asio::basic_waitable_timer via std::unique_ptr.
+ * Instances of this class either own boost::asio::io_service (default mode) or share the one
+ * provided by ::stream_client::reactor (shared-reactor mode).
  * Inherited classes should implement deadline_actor() which is called when timer goes off.
  *
- * @note This class does neither run nor poll its' io_service, it is up to descendants.
+ * @note In default mode this class does neither run nor poll its' io_service, it is up to descendants.
+ *      In shared-reactor mode handlers are executed by the reactor threads and descendants
+ *      should block via wait_io() instead of running the io_service themselves.
  *
  * @tparam Clock type of clock to use, see boost::asio::basic_waitable_timer
  */
@@ -42,32 +49,32 @@ public:
     class expiration final
     {
     public:
-        expiration(timer_type* timer = nullptr)
-            : timer_(timer)
+        expiration(timed_base<Clock>* owner = nullptr)
+            : owner_(owner)
         {
         }
 
-        expiration(timer_type* timer, const time_duration_type& duration)
-            : expiration(timer)
+        expiration(timed_base<Clock>* owner, const time_duration_type& duration)
+            : expiration(owner)
         {
             if (duration < kDurationResolution) {
                 throw boost::system::system_error{boost::asio::error::timed_out};
             }
             if (duration == kInfiniteDuration) {
-                timer_ = nullptr;
+                owner_ = nullptr;
                 return;
             }
 
-            if (timer_) {
-                timer_->expires_from_now(duration);
+            if (owner_) {
+                owner_->arm_deadline(duration);
             }
         }
 
-        expiration(timer_type* timer, const time_point_type& deadline)
-            : expiration(timer)
+        expiration(timed_base<Clock>* owner, const time_point_type& deadline)
+            : expiration(owner)
         {
-            if (timer_) {
-                timer_->expires_at(deadline);
+            if (owner_) {
+                owner_->arm_deadline(deadline);
             }
         }
 
@@ -83,32 +90,38 @@ public:
         // move assignment
         inline expiration& operator=(expiration&& other) noexcept
         {
-            timer_ = std::exchange(other.timer_, nullptr);
+            owner_ = std::exchange(other.owner_, nullptr);
             return *this;
         }
 
         ~expiration()
         {
-            if (timer_) {
-                timer_->expires_from_now(kInfiniteDuration);
+            reset();
+        }
+
+        /// Disarm the deadline prematurely. Subsequent destruction is no-op.
+        inline void reset()
+        {
+            if (owner_) {
+                owner_->disarm_deadline();
+                owner_ = nullptr;
             }
         }
 
     private:
-        timer_type* timer_;
+        timed_base<Clock>* owner_;
     };
 
-    /// Default constructor.
+    /// Default constructor. Allocates own io_service and runs in default (owned) mode.
     timed_base()
-        : deadline_fired_(false)
-        , io_service_(std::make_unique<boost::asio::io_service>())
-        , timer_(std::make_unique<timer_type>(*io_service_))
+        : timed_base(nullptr)
+    {
+    }
+
+    /// Parametrized constructor. Multiplexes the timer onto shared @p io_reactor.
+    timed_base(::stream_client::reactor& io_reactor)
+        : timed_base(&io_reactor)
     {
-        // No deadline is required until the first operation is started. We
-        // set the deadline to positive infinity so the actor takes no action
-        // until a specific deadline is set.
-        timer_->expires_from_now(kInfiniteDuration);
-        post_deadline();
     }
 
     /// Copy constructor is not permitted.
@@ -123,17 +136,25 @@ public:
     /// Destructor.
     virtual ~timed_base()
     {
-        if (io_service_) {
-            io_service_->stop();
+        if (owned_io_service_) {
+            owned_io_service_->stop();
+        } else if (shared_) {
+            // reactor threads may still run deadline handlers referencing this instance
+            std::unique_lock<std::mutex> lk(shared_->mutex);
+            shared_->stopped = true;
+            if (shared_->pending_deadlines > 0) {
+                timer_->cancel();
+            }
+            shared_->cv.wait(lk, [this] { return shared_->pending_deadlines == 0; });
         }
     }
 
-    /// Non-const accessor to owned boost::asio::io_service.
+    /// Non-const accessor to used boost::asio::io_service.
     inline boost::asio::io_service& get_io_service()
     {
         return *io_service_;
     }
-    /// Const accessor to owned boost::asio::io_service.
+    /// Const accessor to used boost::asio::io_service.
     inline const boost::asio::io_service& get_io_service() const
     {
         return *io_service_;
@@ -151,16 +172,146 @@ public:
     expiration scope_expire(const Time& timeout_or_deadline)
     {
         deadline_fired_ = false;
-        return expiration(timer_.get(), timeout_or_deadline);
+        return expiration(this, timeout_or_deadline);
     }
 
 protected:
+    /// Parametrized constructor. If @p io_reactor is nullptr own io_service is allocated.
+    timed_base(::stream_client::reactor* io_reactor)
+        : deadline_fired_(false)
+    {
+        if (io_reactor) {
+            io_service_ = &io_reactor->get_io_service();
+            shared_ = std::make_shared<shared_state>();
+        } else {
+            owned_io_service_ = std::make_unique<boost::asio::io_service>();
+            io_service_ = owned_io_service_.get();
+        }
+        timer_ = std::make_unique<timer_type>(*io_service_);
+
+        // No deadline is required until the first operation is started. We
+        // set the deadline to positive infinity so the actor takes no action
+        // until a specific deadline is set.
+        timer_->expires_at(time_point_type::max());
+        if (owned_io_service_) {
+            // in shared-reactor mode deadline waits are posted on demand, see arm_deadline()
+            post_deadline();
+        }
+    }
+
     /// To-be implemented timer handler. Called if timer goes past expiration point.
     virtual void deadline_actor() = 0;
 
+    /**
+     * Block until @p pred becomes true.
+     * In owned mode runs the io_service; in shared-reactor mode waits on internal
+     * condition variable notified by complete_io() from the reactor threads.
+     *
+     * @tparam Predicate Type of @p pred, should be callable and return bool.
+     * @param[in] pred Condition to wait for.
+     */
+    template <typename Predicate>
+    void wait_io(Predicate&& pred)
+    {
+        if (!shared_) {
+            while (!pred()) {
+                io_service_->run_one();
+            }
+            io_service_->reset();
+            return;
+        }
+        std::unique_lock<std::mutex> lk(shared_->mutex);
+        shared_->cv.wait(lk, std::forward<Predicate>(pred));
+    }
+
+    /**
+     * Run I/O completion and wake wait_io() waiters.
+     * Should be called by completion wrappers of descendants with a functor
+     * invoking the user handler.
+     *
+     * @tparam Completion Type of @p completion, should be callable.
+     * @param[in] completion Functor calling the user completion handler.
+     */
+    template <typename Completion>
+    void complete_io(Completion&& completion)
+    {
+        if (!shared_) {
+            completion();
+            return;
+        }
+        // keep the state alive: once completion() sets its result the waiter
+        // is free to return and destroy this instance
+        const auto state = shared_;
+        {
+            std::lock_guard<std::mutex> lk(state->mutex);
+            completion();
+        }
+        state->cv.notify_all();
+    }
+
     bool deadline_fired_; ///< Set before deadline_actor() called
 
 private:
+    /// Shared-reactor mode synchronization state.
+    struct shared_state
+    {
+        std::mutex mutex; ///< Guards I/O completions, the soft deadline and @p pending_deadlines.
+        std::condition_variable cv; ///< Notified on I/O completion and deadline handler exit.
+        std::size_t pending_deadlines{0}; ///< Number of posted deadline waits not yet finished.
+        bool stopped{false}; ///< Set by the destructor to stop deadline wait reposting.
+    };
+
+    static inline time_point_type to_deadline(const time_duration_type& timeout)
+    {
+        return clock_type::now() + timeout;
+    }
+    static inline time_point_type to_deadline(const time_point_type& deadline)
+    {
+        return deadline;
+    }
+
+    /**
+     * Track a new deadline for the upcoming operation.
+     * Only the soft deadline is updated; the underlying timer is touched lazily —
+     * when it is not waiting yet or would wake up too late. With a steady stream of
+     * operations the common case is a plain member store, no timer cancel/re-post.
+     */
+    template <typename Time>
+    void arm_deadline(const Time& timeout_or_deadline)
+    {
+        const time_point_type deadline = to_deadline(timeout_or_deadline);
+        if (!shared_) {
+            soft_deadline_ = deadline;
+            if (timer_->expires_at() > deadline) {
+                // the timer would wake up too late, pull it in; check_deadline() re-posts the wait
+                timer_->expires_at(deadline);
+            }
+            return;
+        }
+
+        std::lock_guard<std::mutex> lk(shared_->mutex);
+        soft_deadline_ = deadline;
+        if (shared_->pending_deadlines == 0) {
+            ++shared_->pending_deadlines;
+            timer_->expires_at(deadline);
+            timer_->async_wait([this](const boost::system::error_code&) { this->check_deadline_shared(); });
+        } else if (timer_->expires_at() > deadline) {
+            // the posted wait would wake up too late, pull it in; check_deadline_shared() re-posts
+            timer_->expires_at(deadline);
+        }
+    }
+
+    /// Clear the soft deadline. A possibly pending timer wait is left to expire and clean up itself.
+    void disarm_deadline()
+    {
+        if (!shared_) {
+            soft_deadline_ = time_point_type::max();
+            return;
+        }
+        std::lock_guard<std::mutex> lk(shared_->mutex);
+        soft_deadline_ = time_point_type::max();
+    }
+
     inline void post_deadline()
     {
         timer_->async_wait([this](const boost::system::error_code& ec) { this->check_deadline(ec); });
@@ -168,17 +319,47 @@ private:
 
     void check_deadline(const boost::system::error_code& /*ec*/)
     {
-        if (timer_->expires_at() <= clock_type::now()) {
+        const auto now = clock_type::now();
+        if (soft_deadline_ <= now) {
             deadline_actor();
             deadline_fired_ = true;
-            timer_->expires_from_now(kInfiniteDuration);
+            soft_deadline_ = time_point_type::max();
+        }
+        if (timer_->expires_at() <= now) {
+            // wake up next time at the currently tracked deadline (or sleep indefinitely)
+            timer_->expires_at(soft_deadline_);
         }
-        // if deadline fired or reset to new one, check_deadline() gets reposted
         post_deadline();
     }
 
-    std::unique_ptr<boost::asio::io_service> io_service_; ///< Movable boost::asio::io_service handler
+    /// Shared-reactor mode deadline handler; re-posts itself only while a deadline is tracked.
+    void check_deadline_shared()
+    {
+        // keep the state alive past the decrement, destructor may be waiting on it
+        const auto state = shared_;
+        std::unique_lock<std::mutex> lk(state->mutex);
+        const auto now = clock_type::now();
+        if (soft_deadline_ <= now) {
+            deadline_actor();
+            deadline_fired_ = true;
+            soft_deadline_ = time_point_type::max();
+        }
+        if (soft_deadline_ != time_point_type::max() && !state->stopped) {
+            // an armed deadline is still ahead, keep waiting for it
+            timer_->expires_at(soft_deadline_);
+            timer_->async_wait([this](const boost::system::error_code&) { this->check_deadline_shared(); });
+            return;
+        }
+        --state->pending_deadlines;
+        lk.unlock();
+        state->cv.notify_all();
+    }
+
+    std::unique_ptr<boost::asio::io_service> owned_io_service_; ///< Owned io_service; nullptr in shared-reactor mode
+    boost::asio::io_service* io_service_; ///< Used io_service, either owned or reactor's one
     std::unique_ptr<timer_type> timer_; ///< Movable boost::asio::basic_waitable_timer handler
+    time_point_type soft_deadline_{time_point_type::max()}; ///< Deadline of the in-flight operation, if any
+    std::shared_ptr<shared_state> shared_; ///< Shared-reactor mode state; nullptr in owned mode
 };
 
 template <typename Clock>
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <algorithm>
 #include <iomanip>
 #include <iostream>
 #include <mutex>
@@ -70,6 +71,100 @@ inline void cout_logger::message(log_level level, const std::string& location, c
     std::cout << ss.str();
 }
 
+inline async_logger::async_logger(log_level level, std::shared_ptr<log_interface> downstream, std::size_t capacity)
+    : base_logger(level)
+    , downstream_(std::move(downstream))
+{
+    std::size_t ring_size = 1;
+    while (ring_size < capacity) {
+        ring_size <<= 1;
+    }
+    ring_ = std::vector<slot>(ring_size);
+    ring_mask_ = ring_size - 1;
+    for (std::size_t i = 0; i < ring_size; ++i) {
+        ring_[i].sequence.store(i, std::memory_order_relaxed);
+    }
+    drain_thread_ = std::thread([this]() { this->drain_routine(); });
+}
+
+inline async_logger::~async_logger()
+{
+    drain_.store(false, std::memory_order_release);
+    if (drain_thread_.joinable()) {
+        drain_thread_.join();
+    }
+}
+
+inline void async_logger::message(log_level level, const std::string& location, const std::string& message) const
+{
+    log_record record;
+    record.level = level;
+    location.copy(record.location, log_record::kLocationSize - 1);
+    record.location[std::min(location.size(), log_record::kLocationSize - 1)] = '\0';
+    message.copy(record.message, log_record::kMessageSize - 1);
+    record.message[std::min(message.size(), log_record::kMessageSize - 1)] = '\0';
+
+    if (!try_push(record)) {
+        dropped_.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+inline bool async_logger::try_push(const log_record& record) const
+{
+    std::size_t pos = enqueue_pos_.load(std::memory_order_relaxed);
+    slot* claimed = nullptr;
+    for (;;) {
+        slot& candidate = ring_[pos & ring_mask_];
+        const std::size_t sequence = candidate.sequence.load(std::memory_order_acquire);
+        const auto diff = static_cast<std::intptr_t>(sequence) - static_cast<std::intptr_t>(pos);
+        if (diff == 0) {
+            if (enqueue_pos_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                claimed = &candidate;
+                break;
+            }
+        } else if (diff < 0) {
+            // consumer has not freed this slot yet - the ring is full
+            return false;
+        } else {
+            pos = enqueue_pos_.load(std::memory_order_relaxed);
+        }
+    }
+    claimed->record = record;
+    claimed->sequence.store(pos + 1, std::memory_order_release);
+    return true;
+}
+
+inline bool async_logger::try_pop(log_record& record)
+{
+    slot& candidate = ring_[dequeue_pos_ & ring_mask_];
+    const std::size_t sequence = candidate.sequence.load(std::memory_order_acquire);
+    if (static_cast<std::intptr_t>(sequence) - static_cast<std::intptr_t>(dequeue_pos_ + 1) < 0) {
+        return false;
+    }
+    record = candidate.record;
+    candidate.sequence.store(dequeue_pos_ + ring_mask_ + 1, std::memory_order_release);
+    ++dequeue_pos_;
+    return true;
+}
+
+inline void async_logger::drain_routine()
+{
+    log_record record;
+    for (;;) {
+        if (try_pop(record)) {
+            if (downstream_) {
+                downstream_->message(record.level, record.location, record.message);
+            }
+            continue;
+        }
+        if (!drain_.load(std::memory_order_acquire)) {
+            // stopped and nothing left to flush
+            return;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+}
+
 inline void set_logger(std::shared_ptr<log_interface> logger)
 {
     detail::logger_instance(std::move(logger));
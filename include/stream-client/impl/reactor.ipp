@@ -0,0 +1,25 @@
+#pragma once
+
+namespace stream_client {
+
+inline reactor::reactor(std::size_t thread_count)
+    : work_(std::make_unique<boost::asio::io_service::work>(io_service_))
+{
+    threads_.reserve(thread_count);
+    for (std::size_t i = 0; i < thread_count; ++i) {
+        threads_.emplace_back([this]() { this->io_service_.run(); });
+    }
+}
+
+inline reactor::~reactor()
+{
+    work_.reset();
+    io_service_.stop();
+    for (auto& thread : threads_) {
+        if (thread.joinable()) {
+            thread.join();
+        }
+    }
+}
+
+} // namespace stream_client
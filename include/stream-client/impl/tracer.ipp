@@ -0,0 +1,26 @@
+#pragma once
+
+#include <mutex>
+
+namespace stream_client {
+namespace detail {
+
+/// Storage for the global trace sink; no sink by default.
+inline std::shared_ptr<trace_sink>& tracer_storage()
+{
+    static std::shared_ptr<trace_sink> glob_instance;
+    return glob_instance;
+}
+
+inline std::shared_ptr<trace_sink> tracer_instance()
+{
+    return tracer_storage();
+}
+
+inline void tracer_instance(std::shared_ptr<trace_sink> new_sink)
+{
+    tracer_storage() = std::move(new_sink);
+}
+
+} // namespace detail
+} // namespace stream_client
@@ -1,11 +1,15 @@
 #pragma once
 
+#include <atomic>
 #include <chrono>
+#include <cstdint>
 #include <functional>
 #include <memory>
 #include <mutex>
 #include <stdexcept>
 #include <string>
+#include <thread>
+#include <vector>
 
 // TODO: Move to __FILE_NAME__ with gcc 12.1+
 #define FILE_NAME (__builtin_strrchr("/" __FILE__, '/') + 1)
@@ -207,6 +211,91 @@ private:
     mutable std::mutex mutex_; ///< Mutex to sync std::cout calls.
 };
 
+/**
+ * Logger decoupling message delivery from the calling thread.
+ * Callers copy the message into a fixed-size record in a lock-free bounded
+ * ring (one Vyukov-style CAS plus a bounded memcpy, no mutex and no heap),
+ * while a dedicated drain thread assembles and forwards records to the
+ * wrapped downstream logger. When the ring is full records are dropped and
+ * counted instead of blocking the hot path; see dropped_count().
+ *
+ * @note Location and message are truncated to the fixed record size.
+ */
+class async_logger: public stream_client::base_logger
+{
+public:
+    /**
+     * Construct async logger draining into @p downstream.
+     *
+     * @param[in] level Logger level to start with.
+     * @param[in] downstream Logger to deliver records to from the drain thread.
+     * @param[in] capacity Ring capacity in records, rounded up to a power of two.
+     */
+    async_logger(log_level level, std::shared_ptr<log_interface> downstream, std::size_t capacity = 8192);
+
+    /// Copy constructor is not permitted.
+    async_logger(const async_logger& other) = delete;
+    /// Copy assignment is not permitted.
+    async_logger& operator=(const async_logger& other) = delete;
+    /// Move constructor is not permitted.
+    async_logger(async_logger&& other) = delete;
+    /// Move assignment is not permitted.
+    async_logger& operator=(async_logger&& other) = delete;
+
+    /// Destructor. Flushes records still in the ring before stopping the drain thread.
+    virtual ~async_logger();
+
+    /// Enqueue the message for asynchronous delivery; drops it if the ring is full.
+    virtual void message(log_level level, const std::string& location, const std::string& message) const override;
+
+    /**
+     * Get number of records dropped because the ring was full.
+     *
+     * @returns Drop counter value.
+     */
+    inline std::uint64_t dropped_count() const
+    {
+        return dropped_.load(std::memory_order_relaxed);
+    }
+
+private:
+    /// Fixed-size record the hot path copies into; assembled into strings on the drain thread.
+    struct log_record
+    {
+        static const std::size_t kLocationSize = 64; ///< Location truncation limit.
+        static const std::size_t kMessageSize = 256; ///< Message truncation limit.
+
+        log_level level; ///< Level of the message.
+        char location[kLocationSize]; ///< Zero-terminated, truncated location.
+        char message[kMessageSize]; ///< Zero-terminated, truncated message.
+    };
+
+    /// Ring slot: record plus its sequence number for lock-free hand-off.
+    struct slot
+    {
+        std::atomic<std::size_t> sequence; ///< Vyukov-style slot sequence.
+        log_record record; ///< Stored record.
+    };
+
+    /// Try to push a record; returns false if the ring is full.
+    bool try_push(const log_record& record) const;
+
+    /// Try to pop a record into @p record; returns false if the ring is empty.
+    bool try_pop(log_record& record);
+
+    /// Drain thread routine: forward records downstream until stopped and empty.
+    void drain_routine();
+
+    std::shared_ptr<log_interface> downstream_; ///< Logger records are delivered to.
+    mutable std::vector<slot> ring_; ///< Bounded MPSC ring buffer.
+    std::size_t ring_mask_; ///< Capacity - 1, capacity is a power of two.
+    mutable std::atomic<std::size_t> enqueue_pos_{0}; ///< Producers' claim counter.
+    std::size_t dequeue_pos_{0}; ///< Consumer position, drain thread only.
+    mutable std::atomic<std::uint64_t> dropped_{0}; ///< Records dropped on full ring.
+    std::atomic<bool> drain_{true}; ///< Cleared to stop @p drain_thread_.
+    std::thread drain_thread_; ///< Thread running drain_routine().
+};
+
 /**
  * Set logger for the library.
  *
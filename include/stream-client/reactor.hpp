@@ -0,0 +1,73 @@
+#pragma once
+
+#include <boost/asio/io_service.hpp>
+
+#include <memory>
+#include <thread>
+#include <vector>
+
+namespace stream_client {
+
+/**
+ * Shared I/O reactor to multiplex timers and I/O of multiple sockets.
+ *
+ * By default every socket owns its' boost::asio::io_service which means one
+ * reactor, one timer and one epoll descriptor per connection. Sockets
+ * constructed against a reactor instance share single io_service instead,
+ * which removes per-connection reactor setup/teardown and reduces memory
+ * footprint for processes with hundreds of pooled connections.
+ *
+ * The reactor owns background thread(s) which run the io_service, so
+ * completion handlers of member sockets are executed there, while calling
+ * threads only block on a condition variable until their operation is done.
+ *
+ * @note Thread-safe. Single instance can be shared by any number of sockets,
+ *      connectors and pools.
+ * @note With @p thread_count == 1 (default) all handlers are serialized.
+ *      To utilize multiple cores create several reactors and shard sockets
+ *      across them instead of increasing @p thread_count, since handlers of a
+ *      single socket are not synchronized between themselves.
+ */
+class reactor
+{
+public:
+    /**
+     * Parametrized constructor.
+     * Creates reactor and starts @p thread_count background threads to run it.
+     *
+     * @param[in] thread_count Number of threads running the io_service.
+     */
+    reactor(std::size_t thread_count = 1);
+
+    /// Copy constructor is not permitted.
+    reactor(const reactor& other) = delete;
+    /// Copy assignment is not permitted.
+    reactor& operator=(const reactor& other) = delete;
+    /// Move constructor is not permitted.
+    reactor(reactor&& other) = delete;
+    /// Move assignment is not permitted.
+    reactor& operator=(reactor&& other) = delete;
+
+    /// Destructor. Stops the io_service and joins background threads.
+    ~reactor();
+
+    /// Non-const accessor to owned boost::asio::io_service.
+    inline boost::asio::io_service& get_io_service()
+    {
+        return io_service_;
+    }
+    /// Const accessor to owned boost::asio::io_service.
+    inline const boost::asio::io_service& get_io_service() const
+    {
+        return io_service_;
+    }
+
+private:
+    boost::asio::io_service io_service_; ///< Shared io_service to run member sockets on.
+    std::unique_ptr<boost::asio::io_service::work> work_; ///< Keeps io_service running while there is no I/O.
+    std::vector<std::thread> threads_; ///< Threads to run @p io_service_ in.
+};
+
+} // namespace stream_client
+
+#include "impl/reactor.ipp"
@@ -1,5 +1,7 @@
 #pragma once
 
+#include "stream-client/tracer.hpp"
+
 namespace stream_client {
 namespace resolver {
 
@@ -28,6 +30,7 @@ template <typename Time>
 typename base_resolver<Protocol>::iterator_type base_resolver<Protocol>::resolve(boost::system::error_code& ec,
                                                                                  const Time& timeout_or_deadline)
 {
+    ::stream_client::detail::trace_scope span(::stream_client::trace_phase::resolve);
     iterator_type endpoints;
     ec = boost::asio::error::would_block;
 
@@ -45,6 +48,7 @@ typename base_resolver<Protocol>::iterator_type base_resolver<Protocol>::resolve
     while (ec == boost::asio::error::would_block) {
         get_io_service().run_one();
     };
+    span.set_error(ec.value());
     return endpoints;
 }
 
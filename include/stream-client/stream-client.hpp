@@ -2,9 +2,12 @@
 
 #include <stream-client/connector/connection_pool.hpp>
 #include <stream-client/connector/connector.hpp>
+#include <stream-client/connector/sharded_connection_pool.hpp>
 #include <stream-client/logger.hpp>
+#include <stream-client/reactor.hpp>
 #include <stream-client/resolver/resolver.hpp>
 #include <stream-client/stream/dgram_socket.hpp>
 #include <stream-client/stream/http_socket.hpp>
 #include <stream-client/stream/ssl_stream_socket.hpp>
 #include <stream-client/stream/stream_socket.hpp>
+#include <stream-client/tracer.hpp>
@@ -2,8 +2,68 @@
 
 #include "stream-client/detail/timed_base.hpp"
 
+#include <atomic>
+
 namespace stream_client {
 
+namespace detail {
+
+/// Storage for the process-wide TCP Fast Open opt-in flag; off by default.
+inline std::atomic<bool>& tcp_fastopen_flag()
+{
+    static std::atomic<bool> flag{false};
+    return flag;
+}
+
+} // namespace detail
+
+/**
+ * Opt in to TCP Fast Open for subsequently created TCP sockets.
+ * With the option on, sockets are created with TCP_FASTOPEN_CONNECT (Linux 4.11+):
+ * connect() completes at once and the SYN is sent with the first write, carrying
+ * the payload when a Fast Open cookie for the peer is cached - saving one round
+ * trip on every reconnect to a known upstream. On kernels or platforms without
+ * support the regular handshake is used transparently.
+ *
+ * @note With Fast Open a refused or unreachable peer surfaces at the first
+ *      I/O operation instead of at connect time.
+ *
+ * @param[in] enabled true to enable Fast Open for new sockets.
+ */
+inline void set_tcp_fastopen(bool enabled)
+{
+    detail::tcp_fastopen_flag().store(enabled, std::memory_order_relaxed);
+}
+
+/// Tell if TCP Fast Open is enabled for new sockets, see set_tcp_fastopen().
+inline bool tcp_fastopen_enabled()
+{
+    return detail::tcp_fastopen_flag().load(std::memory_order_relaxed);
+}
+
+/**
+ * Kernel tuning knobs applied to a socket between open and connect.
+ *
+ * Options set this early are in place for the handshake and the first congestion
+ * window, which options applied after connect miss. All knobs are best-effort:
+ * values the kernel clamps or options the platform lacks do not fail the connect.
+ * Zero (or false) leaves the corresponding kernel default untouched, so a
+ * default-constructed profile changes nothing.
+ */
+struct socket_profile
+{
+    int send_buffer_size{0}; ///< SO_SNDBUF in bytes; throughput-oriented pools want it large.
+    int receive_buffer_size{0}; ///< SO_RCVBUF in bytes.
+    int busy_poll_us{0}; ///< SO_BUSY_POLL microseconds; trades CPU for receive latency. Linux only.
+    int notsent_lowat{0}; ///< TCP_NOTSENT_LOWAT in bytes; caps unsent data buffered in-kernel. Linux only.
+
+    /// Tell if any knob deviates from the kernel defaults.
+    inline bool tuned() const
+    {
+        return send_buffer_size > 0 || receive_buffer_size > 0 || busy_poll_us > 0 || notsent_lowat > 0;
+    }
+};
+
 /**
  * Socket client for arbitrary plain (no encryption) protocol.
  *
@@ -31,6 +91,8 @@ public:
         const endpoint_type& peer_endpoint; ///< Endpoint to connect
         time_duration_type connect_timeout; ///< Connection timeout
         time_duration_type operation_timeout; ///< Any rw function timeout
+        ::stream_client::reactor* io_reactor = nullptr; ///< Shared reactor to run on; optional
+        socket_profile profile = socket_profile(); ///< Kernel tuning knobs applied before connect; optional
     };
 
     /**
@@ -41,11 +103,30 @@ public:
      * @param[in] peer_endpoint Remote endpoint to connect.
      * @param[in] connect_timeout Timeout for connection operation.
      * @param[in] operation_timeout Subsequent I/O operation default timeout.
+     * @param[in] profile Kernel tuning knobs applied between socket open and connect.
      *
      * @throws boost::system::system_error Thrown on failure.
      */
     base_socket(const endpoint_type& peer_endpoint, time_duration_type connect_timeout,
-                time_duration_type operation_timeout);
+                time_duration_type operation_timeout, socket_profile profile = socket_profile());
+
+    /**
+     * Parametrized constructor with shared reactor.
+     * Same as the default one but the socket is multiplexed onto @p io_reactor
+     * instead of allocating own io_service and running it in calling threads.
+     *
+     * @param[in] io_reactor Shared reactor to run I/O and timers on.
+     * @param[in] peer_endpoint Remote endpoint to connect.
+     * @param[in] connect_timeout Timeout for connection operation.
+     * @param[in] operation_timeout Subsequent I/O operation default timeout.
+     * @param[in] profile Kernel tuning knobs applied between socket open and connect.
+     *
+     * @throws boost::system::system_error Thrown on failure.
+     */
+    base_socket(::stream_client::reactor& io_reactor, const endpoint_type& peer_endpoint,
+                time_duration_type connect_timeout, time_duration_type operation_timeout,
+                socket_profile profile = socket_profile());
+
     /// Single-argument constructor. Needed to use it as base for boost::asio::ssl::stream.
     base_socket(const config& cfg);
 
@@ -292,6 +373,12 @@ public:
         return next_layer().is_open();
     }
 
+    /// Get the tuning profile this socket was created with, see socket_profile.
+    inline const socket_profile& profile() const
+    {
+        return profile_;
+    }
+
 protected:
     /// Timeout expiration handler which closes current socket.
     virtual void deadline_actor() override;
@@ -306,10 +393,19 @@ protected:
     void async_receive(const MutableBufferSequence& buffers, const Time& timeout_or_deadline, ReadHandler&& handler,
                        bool setup_expiration);
 
+    /// Delegated constructor. If @p io_reactor is nullptr the socket owns its' io_service.
+    base_socket(::stream_client::reactor* io_reactor, const endpoint_type& peer_endpoint,
+                time_duration_type connect_timeout, time_duration_type operation_timeout,
+                socket_profile profile = socket_profile());
+
+    /// Apply @p profile_ knobs on the freshly opened socket; best-effort, never throws.
+    void apply_profile();
+
     next_layer_type socket_; ///< Underlying socket to perform I/O operations
     time_duration_type connection_timeout_; ///< Connection timeout value used upon construction
     time_duration_type io_operation_timeout_; ///< Current I/O timeout value
     bool io_timeouted_; ///< Flag to track current I/O timeout state
+    socket_profile profile_; ///< Kernel tuning knobs applied upon construction
 };
 
 } // namespace stream_client
@@ -0,0 +1,96 @@
+#pragma once
+
+#include <boost/beast/core/flat_buffer.hpp>
+
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace stream_client {
+namespace http {
+namespace detail {
+
+/**
+ * Process-wide free-list of receive buffers shared across HTTP sessions.
+ *
+ * A flat buffer grows to the largest response its session ever parsed and,
+ * without recycling, that capacity dies with the session - so pools that
+ * constantly evict and re-establish sessions churn large allocations through
+ * the allocator, and total retained memory scales with pool size. Sessions
+ * borrow a buffer here on construction and return it on destruction, so the
+ * grown capacity is reused by the next session and the number of retained
+ * buffers is bounded by actual concurrency (capped at kMaxPooled).
+ *
+ * @note Thread-safe; meant to be shared by concurrent pool refill threads.
+ */
+class recycled_buffer_pool
+{
+public:
+    using buffer_type = boost::beast::basic_flat_buffer<std::allocator<char>>;
+
+    /// Number of idle buffers kept for reuse; beyond it released buffers are freed.
+    static const std::size_t kMaxPooled = 64;
+
+    /// Get process-wide pool instance.
+    static recycled_buffer_pool& instance()
+    {
+        static recycled_buffer_pool pool;
+        return pool;
+    }
+
+    /// Copy constructor is not permitted.
+    recycled_buffer_pool(const recycled_buffer_pool& other) = delete;
+    /// Copy assignment is not permitted.
+    recycled_buffer_pool& operator=(const recycled_buffer_pool& other) = delete;
+
+    /**
+     * Borrow a buffer, reusing a previously released one when available.
+     * Reused buffers come back empty but keep their grown capacity, so a
+     * session taking over from a busy predecessor skips the warm-up growth.
+     *
+     * @note All HTTP sessions use the same size limit, so a reused buffer's
+     *      limit always matches @p limit.
+     *
+     * @param[in] limit Maximum buffer size for a freshly constructed buffer.
+     *
+     * @returns An empty buffer ready for use.
+     */
+    buffer_type acquire(std::size_t limit)
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (!free_list_.empty()) {
+                buffer_type buffer = std::move(free_list_.back());
+                free_list_.pop_back();
+                return buffer;
+            }
+        }
+        return buffer_type(limit);
+    }
+
+    /**
+     * Return a borrowed buffer for reuse.
+     * The content is discarded, the capacity is kept. Buffers past the
+     * kMaxPooled cap are simply destroyed.
+     *
+     * @param[in] buffer Buffer to recycle.
+     */
+    void release(buffer_type&& buffer)
+    {
+        buffer.consume(buffer.size());
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (free_list_.size() < kMaxPooled) {
+            free_list_.emplace_back(std::move(buffer));
+        }
+    }
+
+private:
+    recycled_buffer_pool() = default;
+
+    std::mutex mutex_; ///< Guards @p free_list_.
+    std::vector<buffer_type> free_list_; ///< Idle buffers awaiting reuse.
+};
+
+} // namespace detail
+} // namespace http
+} // namespace stream_client
@@ -0,0 +1,124 @@
+#pragma once
+
+#include <boost/asio/ssl/context.hpp>
+
+#include <openssl/ssl.h>
+
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+namespace stream_client {
+namespace ssl {
+namespace detail {
+
+/**
+ * Process-wide TLS client session cache.
+ *
+ * Holds a single shared boost::asio::ssl::context (so CA paths are loaded once
+ * per process instead of per connection) and the most recently negotiated
+ * SSL_SESSION per upstream host. Cached sessions are offered to new streams
+ * before handshaking, turning reconnects into abbreviated (TLS 1.2) or
+ * PSK-resumed (TLS 1.3) handshakes.
+ *
+ * @note Thread-safe; meant to be shared by concurrent pool refill threads.
+ */
+class ssl_session_cache
+{
+public:
+    /// Get process-wide cache instance.
+    static ssl_session_cache& instance()
+    {
+        static ssl_session_cache cache;
+        return cache;
+    }
+
+    /// Copy constructor is not permitted.
+    ssl_session_cache(const ssl_session_cache& other) = delete;
+    /// Copy assignment is not permitted.
+    ssl_session_cache& operator=(const ssl_session_cache& other) = delete;
+
+    /**
+     * Get shared client-side context.
+     * The context has default verify paths preloaded; per-stream settings
+     * (verification mode, SNI) are applied on the stream, not here.
+     *
+     * @returns Shared pointer to the context.
+     */
+    std::shared_ptr<boost::asio::ssl::context> shared_context() const
+    {
+        return context_;
+    }
+
+    /**
+     * Offer a previously cached session for @p host to @p ssl_handle.
+     * No-op if there is nothing cached for @p host.
+     *
+     * @param[in] ssl_handle Native handle of the stream about to handshake.
+     * @param[in] host Upstream host the stream connects to.
+     */
+    void attach(::SSL* ssl_handle, const std::string& host)
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        const auto it = sessions_.find(host);
+        if (it != sessions_.end()) {
+            ::SSL_set_session(ssl_handle, it->second.get());
+        }
+    }
+
+    /**
+     * Remember the session negotiated on @p ssl_handle for future connections to @p host.
+     * Stored unconditionally since TLS 1.3 tickets are single-use and a fresh
+     * one may have arrived even on a resumed connection.
+     *
+     * @param[in] ssl_handle Native handle of the handshaked stream.
+     * @param[in] host Upstream host the stream is connected to.
+     */
+    void store(::SSL* ssl_handle, const std::string& host)
+    {
+        session_ptr session(::SSL_get1_session(ssl_handle));
+        if (!session) {
+            return;
+        }
+
+        std::lock_guard<std::mutex> lock(mutex_);
+        sessions_[host] = std::move(session);
+    }
+
+    /**
+     * Number of hosts with a cached session.
+     *
+     * @returns Cache size.
+     */
+    std::size_t size() const
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return sessions_.size();
+    }
+
+private:
+    /// Deleter to drop a reference obtained via SSL_get1_session().
+    struct session_free
+    {
+        void operator()(::SSL_SESSION* session) const
+        {
+            ::SSL_SESSION_free(session);
+        }
+    };
+    using session_ptr = std::unique_ptr<::SSL_SESSION, session_free>;
+
+    ssl_session_cache()
+        : context_(std::make_shared<boost::asio::ssl::context>(boost::asio::ssl::context::sslv23))
+    {
+        context_->set_default_verify_paths();
+    }
+
+    std::shared_ptr<boost::asio::ssl::context> context_; ///< Context shared by all streams using this cache.
+    mutable std::mutex mutex_; ///< Protects sessions_.
+    std::unordered_map<std::string, session_ptr> sessions_; ///< Last negotiated session per host.
+};
+
+} // namespace detail
+} // namespace ssl
+} // namespace stream_client
@@ -5,6 +5,8 @@
 #include <boost/asio/basic_datagram_socket.hpp>
 #include <boost/asio/ip/udp.hpp>
 
+#include <vector>
+
 namespace stream_client {
 
 /**
@@ -140,7 +142,106 @@ public:
         return receive(buffers, this->io_timeout());
     }
 
+    /**
+     * Send a batch of datagrams, one per buffer in @p datagrams.
+     * On Linux the whole batch goes through sendmmsg() under a single timeout scope,
+     * so N small datagrams cost one deadline arm and a few syscalls instead of N
+     * async-op cycles. Elsewhere it falls back to a portable send() loop.
+     *
+     * @tparam Time Type of @p timeout_or_deadline, either time_duration_type or time_point_type.
+     *
+     * @param[in] datagrams Buffers to send, each one as a separate datagram.
+     * @param[out] ec Set to indicate what error occurred, if any.
+     * @param[in] timeout_or_deadline Expiration time-point or duration for the whole batch.
+     *
+     * @returns The number of datagrams fully sent.
+     */
+    template <typename Time>
+    std::size_t send_batch(const std::vector<boost::asio::const_buffer>& datagrams, boost::system::error_code& ec,
+                           const Time& timeout_or_deadline);
+
+    /**
+     * Send a batch of datagrams, one per buffer in @p datagrams.
+     * Same as above but throws on failure.
+     *
+     * @param[in] datagrams Buffers to send, each one as a separate datagram.
+     * @param[in] timeout_or_deadline Expiration time-point or duration for the whole batch.
+     *
+     * @returns The number of datagrams fully sent.
+     * @throws boost::system::system_error Thrown on failure.
+     */
+    template <typename Time>
+    std::size_t send_batch(const std::vector<boost::asio::const_buffer>& datagrams, const Time& timeout_or_deadline);
+
+    /// Alias to send_batch() using current I/O timeout value.
+    inline std::size_t send_batch(const std::vector<boost::asio::const_buffer>& datagrams,
+                                  boost::system::error_code& ec)
+    {
+        return send_batch(datagrams, ec, this->io_timeout());
+    }
+    /// Alias to send_batch() using current I/O timeout value.
+    inline std::size_t send_batch(const std::vector<boost::asio::const_buffer>& datagrams)
+    {
+        return send_batch(datagrams, this->io_timeout());
+    }
+
+    /**
+     * Receive a batch of datagrams, one per buffer in @p datagrams.
+     * Blocks until at least one datagram arrives, then grabs as many as immediately
+     * available up to datagrams.size(). On Linux the batch is drained with a single
+     * recvmmsg() under one timeout scope; elsewhere it falls back to a receive() loop.
+     *
+     * @tparam Time Type of @p timeout_or_deadline, either time_duration_type or time_point_type.
+     *
+     * @param[in] datagrams Buffers to receive into, each one holds a separate datagram.
+     * @param[out] sizes Filled with the payload size of every received datagram.
+     * @param[out] ec Set to indicate what error occurred, if any.
+     * @param[in] timeout_or_deadline Expiration time-point or duration.
+     *
+     * @returns The number of datagrams received.
+     */
+    template <typename Time>
+    std::size_t receive_batch(const std::vector<boost::asio::mutable_buffer>& datagrams,
+                              std::vector<std::size_t>& sizes, boost::system::error_code& ec,
+                              const Time& timeout_or_deadline);
+
+    /**
+     * Receive a batch of datagrams, one per buffer in @p datagrams.
+     * Same as above but throws on failure.
+     *
+     * @param[in] datagrams Buffers to receive into, each one holds a separate datagram.
+     * @param[out] sizes Filled with the payload size of every received datagram.
+     * @param[in] timeout_or_deadline Expiration time-point or duration.
+     *
+     * @returns The number of datagrams received.
+     * @throws boost::system::system_error Thrown on failure.
+     */
+    template <typename Time>
+    std::size_t receive_batch(const std::vector<boost::asio::mutable_buffer>& datagrams,
+                              std::vector<std::size_t>& sizes, const Time& timeout_or_deadline);
+
+    /// Alias to receive_batch() using current I/O timeout value.
+    inline std::size_t receive_batch(const std::vector<boost::asio::mutable_buffer>& datagrams,
+                                     std::vector<std::size_t>& sizes, boost::system::error_code& ec)
+    {
+        return receive_batch(datagrams, sizes, ec, this->io_timeout());
+    }
+    /// Alias to receive_batch() using current I/O timeout value.
+    inline std::size_t receive_batch(const std::vector<boost::asio::mutable_buffer>& datagrams,
+                                     std::vector<std::size_t>& sizes)
+    {
+        return receive_batch(datagrams, sizes, this->io_timeout());
+    }
+
 private:
+    /**
+     * Block until the underlying socket becomes readable/writable under the current deadline.
+     *
+     * @param[in] wait_type Readiness to wait for.
+     * @param[out] ec Set to indicate what error occurred, if any.
+     */
+    void wait_ready(boost::asio::socket_base::wait_type wait_type, boost::system::error_code& ec);
+
     /// Start an asynchronous send with timeout on the underlying socket.
     template <typename ConstBufferSequence, typename WriteHandler, typename Time>
     void async_send(const ConstBufferSequence& buffers, const Time& timeout_or_deadline, WriteHandler&& handler,
@@ -1,20 +1,43 @@
 #pragma once
 
+#include "detail/recycled_buffer_pool.hpp"
 #include "detail/static_allocator.hpp"
 #include "dgram_socket.hpp"
 #include "ssl_stream_socket.hpp"
 #include "stream_socket.hpp"
+#include "stream-client/connector/connect_engine.hpp"
 
+#include <boost/asio/async_result.hpp>
 #include <boost/beast/core/flat_buffer.hpp>
+#include <boost/beast/core/string_type.hpp>
+#include <boost/beast/http/buffer_body.hpp>
 #include <boost/beast/http/message.hpp>
 #include <boost/beast/http/parser.hpp>
 #include <boost/beast/http/read.hpp>
 #include <boost/beast/http/string_body.hpp>
 #include <boost/beast/http/write.hpp>
 
+#include <vector>
+
 namespace stream_client {
 namespace http {
 
+/**
+ * HTTP response with a zero-copy body.
+ *
+ * Returned by base_socket::perform_view(). The status line and headers are owned
+ * by the instance, while @p body references octets inside the internal buffer of
+ * the socket that produced it. The view stays valid until the next operation on
+ * that socket, which fits pooled get->perform->return usage.
+ */
+struct response_view
+{
+    /// Parsed status line and headers of the response.
+    boost::beast::http::response_header<> header;
+    /// Response payload; references the socket's internal buffer, not owned.
+    boost::beast::string_view body;
+};
+
 /**
  * HTTP stream layer.
  *
@@ -35,9 +58,13 @@ public:
     static const size_t kHeaderLimit;
     /// Body length limit for internal parser
     static const size_t kBodyLimit;
+    /// Body chunk size for streaming perform_stream()
+    static const size_t kChunkSize;
 
     using allocator_type = std::allocator<char>;
+    using arena_allocator_type = ::stream_client::stream::detail::static_allocator<char>;
     using next_layer_type = typename std::remove_reference<Stream>::type;
+    using lowest_layer_type = typename next_layer_type::lowest_layer_type;
     using protocol_type = typename next_layer_type::protocol_type;
     using endpoint_type = typename next_layer_type::endpoint_type;
     using clock_type = typename next_layer_type::clock_type;
@@ -62,7 +89,8 @@ public:
                   !std::is_same<typename std::decay<Arg1>::type, base_socket<Stream>>::value>::type>
     base_socket(Arg1&& arg1, ArgN&&... argn)
         : stream_(std::forward<Arg1>(arg1), std::forward<ArgN>(argn)...)
-        , buffer_(kBodyLimit + kHeaderLimit)
+        , buffer_(detail::recycled_buffer_pool::instance().acquire(kBodyLimit + kHeaderLimit))
+        , header_arena_(kHeaderLimit + kHeaderLimit / 5)
     {
     }
 
@@ -75,8 +103,14 @@ public:
     /// Move assignment.
     base_socket<Stream>& operator=(base_socket<Stream>&& other) = default;
 
-    /// Destructor.
-    virtual ~base_socket() = default;
+    /// Destructor. Returns the receive buffer to the shared recycling pool.
+    virtual ~base_socket()
+    {
+        if (buffer_.capacity() > 0) {
+            // a moved-from socket is left with an empty buffer, no point recycling it
+            detail::recycled_buffer_pool::instance().release(std::move(buffer_));
+        }
+    }
 
     /**
      * Perform HTTP request.
@@ -164,6 +198,305 @@ public:
         return *response;
     }
 
+    /**
+     * Perform HTTP request with a zero-copy response body.
+     * Same as perform(), but the body of the returned response is a string_view into
+     * the socket's internal buffer instead of a std::string copy; for plain
+     * (Content-Length delimited) responses no body byte is copied at all.
+     * The returned view is valid until the next operation on this socket.
+     *
+     * @tparam Body Type of the body used in the @p request.
+     * @tparam Fields Type of the fields used in the @p request.
+     *
+     * @param[in] request HTTP request to send.
+     * @param[in] deadline Expiration time-point.
+     * @param[out] ec Set to indicate what error occurred, if any.
+     *
+     * @returns Received response wrapped in boost::optional or boost::none if an error occurred.
+     */
+    template <typename Body, typename Fields>
+    boost::optional<response_view> perform_view(const boost::beast::http::request<Body, Fields>& request,
+                                                boost::system::error_code& ec, const time_point_type& deadline);
+
+    /**
+     * Perform HTTP request with a zero-copy response body.
+     * Same as perform(), but the body of the returned response is a string_view into
+     * the socket's internal buffer, valid until the next operation on this socket.
+     *
+     * @tparam Body Type of the body used in the @p request.
+     * @tparam Fields Type of the fields used in the @p request.
+     *
+     * @param[in] request HTTP request to send.
+     * @param[in] timeout Expiration duration.
+     * @param[out] ec Set to indicate what error occurred, if any.
+     *
+     * @returns Received response wrapped in boost::optional or boost::none if an error occurred.
+     */
+    template <typename Body, typename Fields>
+    inline boost::optional<response_view> perform_view(const boost::beast::http::request<Body, Fields>& request,
+                                                       boost::system::error_code& ec, const time_duration_type& timeout)
+    {
+        return perform_view(request, ec, clock_type::now() + timeout);
+    }
+
+    /**
+     * Perform HTTP request with a zero-copy response body.
+     * Same as perform(), but the body of the returned response is a string_view into
+     * the socket's internal buffer, valid until the next operation on this socket.
+     * Timeout for this operation is defined by stream's I/O default timeout.
+     *
+     * @tparam Body Type of the body used in the @p request.
+     * @tparam Fields Type of the fields used in the @p request.
+     *
+     * @param[in] request HTTP request to send.
+     * @param[out] ec Set to indicate what error occurred, if any.
+     *
+     * @returns Received response wrapped in boost::optional or boost::none if an error occurred.
+     */
+    template <typename Body, typename Fields>
+    inline boost::optional<response_view> perform_view(const boost::beast::http::request<Body, Fields>& request,
+                                                       boost::system::error_code& ec)
+    {
+        return perform_view(request, ec, stream_.io_timeout());
+    }
+
+    /**
+     * Perform HTTP request with a zero-copy response body.
+     * Same as perform(), but the body of the returned response is a string_view into
+     * the socket's internal buffer, valid until the next operation on this socket.
+     * Timeout for this operation is defined by stream's I/O default timeout.
+     *
+     * @tparam Body Type of the body used in the @p request.
+     * @tparam Fields Type of the fields used in the @p request.
+     *
+     * @param[in] request HTTP request to send.
+     *
+     * @returns Received response.
+     * @throws boost::system::system_error Thrown on failure.
+     */
+    template <typename Body, typename Fields>
+    inline response_view perform_view(const boost::beast::http::request<Body, Fields>& request)
+    {
+        boost::system::error_code ec;
+        auto response = perform_view(request, ec);
+        if (ec) {
+            throw boost::system::system_error{ec};
+        }
+        if (!response) {
+            throw boost::system::system_error{boost::asio::error::operation_aborted};
+        }
+        return *response;
+    }
+
+    /**
+     * Perform HTTP request asynchronously.
+     * Initiates the exchange on the process-wide worker engine and returns immediately; the
+     * caller's thread never blocks. Default I/O timeout of the underlying stream applies.
+     *
+     * @note The completion handler is invoked on a worker thread with signature
+     *      void(boost::system::error_code, boost::optional<boost::beast::http::response<Body, Fields>>).
+     *      @p token may be a plain callback or any asio completion token, e.g.
+     *      boost::asio::use_future. The socket and @p request must stay alive and untouched
+     *      until completion; only one operation may be in flight per socket.
+     *
+     * @tparam Body Type of the body used in the @p request.
+     * @tparam Fields Type of the fields used in the @p request.
+     *
+     * @param[in] request HTTP request to send.
+     * @param[in] token Completion token deciding how the result is delivered.
+     */
+    template <typename Body, typename Fields, typename CompletionToken>
+    auto async_perform(const boost::beast::http::request<Body, Fields>& request, CompletionToken&& token)
+    {
+        using response_type = boost::beast::http::response<Body, Fields>;
+        return boost::asio::async_initiate<CompletionToken,
+                                           void(boost::system::error_code, boost::optional<response_type>)>(
+            [this, &request](auto&& handler) {
+                using handler_type = typename std::decay<decltype(handler)>::type;
+                auto handler_ptr = std::make_shared<handler_type>(std::forward<decltype(handler)>(handler));
+                ::stream_client::connector::detail::connect_engine::shared().submit([this, &request, handler_ptr]() {
+                    boost::system::error_code ec;
+                    auto response = this->perform(request, ec);
+                    (*handler_ptr)(ec, std::move(response));
+                });
+            },
+            token);
+    }
+
+    /**
+     * Perform a batch of HTTP requests pipelined over the connection.
+     * All requests are serialized back-to-back and pushed with as few writes as the socket
+     * allows, then the responses are parsed in request order from the shared buffer. For a
+     * burst of N small requests this collapses N round-trips into roughly one.
+     *
+     * @note If an error occurs mid-batch the returned vector holds the responses completed
+     *      so far, i.e. result.size() tells which requests have been answered.
+     *
+     * @tparam Body Type of the body used in the requests.
+     * @tparam Fields Type of the fields used in the requests.
+     *
+     * @param[in] requests HTTP requests to send, pipelined in order.
+     * @param[out] ec Set to indicate what error occurred, if any.
+     * @param[in] deadline Expiration time-point for the whole batch.
+     *
+     * @returns Received responses in request order; shorter than @p requests on error.
+     */
+    template <typename Body, typename Fields>
+    std::vector<boost::beast::http::response<Body, Fields>>
+    perform_batch(const std::vector<boost::beast::http::request<Body, Fields>>& requests,
+                  boost::system::error_code& ec, const time_point_type& deadline);
+
+    /**
+     * Perform a batch of HTTP requests pipelined over the connection.
+     * Same as above but expires within specified time from now.
+     *
+     * @param[in] requests HTTP requests to send, pipelined in order.
+     * @param[out] ec Set to indicate what error occurred, if any.
+     * @param[in] timeout Expiration duration for the whole batch.
+     *
+     * @returns Received responses in request order; shorter than @p requests on error.
+     */
+    template <typename Body, typename Fields>
+    inline std::vector<boost::beast::http::response<Body, Fields>>
+    perform_batch(const std::vector<boost::beast::http::request<Body, Fields>>& requests,
+                  boost::system::error_code& ec, const time_duration_type& timeout)
+    {
+        return perform_batch(requests, ec, clock_type::now() + timeout);
+    }
+
+    /**
+     * Perform a batch of HTTP requests pipelined over the connection.
+     * Same as above; timeout for this operation is defined by stream's I/O default timeout.
+     *
+     * @param[in] requests HTTP requests to send, pipelined in order.
+     * @param[out] ec Set to indicate what error occurred, if any.
+     *
+     * @returns Received responses in request order; shorter than @p requests on error.
+     */
+    template <typename Body, typename Fields>
+    inline std::vector<boost::beast::http::response<Body, Fields>>
+    perform_batch(const std::vector<boost::beast::http::request<Body, Fields>>& requests,
+                  boost::system::error_code& ec)
+    {
+        return perform_batch(requests, ec, stream_.io_timeout());
+    }
+
+    /**
+     * Perform HTTP request streaming the response into a caller-provided parser.
+     * Unlike plain perform() neither internal parser nor its' kBodyLimit is used, so the
+     * response body goes wherever the parser puts it. Pass a parser over
+     * boost::beast::http::file_body to download responses of arbitrary size straight to disk.
+     *
+     * @tparam Body Type of the body used in the @p request.
+     * @tparam Fields Type of the fields used in the @p request.
+     * @tparam Parser Type of response parser, usually boost::beast::http::response_parser.
+     *
+     * @param[in] request HTTP request to send.
+     * @param[in,out] response_parser Parser to drain the response into; limits are up to the caller.
+     * @param[out] ec Set to indicate what error occurred, if any.
+     * @param[in] deadline Expiration time-point.
+     */
+    template <typename Body, typename Fields, typename Parser>
+    void perform(const boost::beast::http::request<Body, Fields>& request, Parser& response_parser,
+                 boost::system::error_code& ec, const time_point_type& deadline);
+
+    /**
+     * Perform HTTP request streaming the response into a caller-provided parser.
+     * Same as above but expires within specified time from now.
+     *
+     * @param[in] request HTTP request to send.
+     * @param[in,out] response_parser Parser to drain the response into; limits are up to the caller.
+     * @param[out] ec Set to indicate what error occurred, if any.
+     * @param[in] timeout Expiration duration.
+     */
+    template <typename Body, typename Fields, typename Parser>
+    inline void perform(const boost::beast::http::request<Body, Fields>& request, Parser& response_parser,
+                        boost::system::error_code& ec, const time_duration_type& timeout)
+    {
+        perform(request, response_parser, ec, clock_type::now() + timeout);
+    }
+
+    /**
+     * Perform HTTP request streaming the response into a caller-provided parser.
+     * Same as above; timeout for this operation is defined by stream's I/O default timeout.
+     *
+     * @param[in] request HTTP request to send.
+     * @param[in,out] response_parser Parser to drain the response into; limits are up to the caller.
+     * @param[out] ec Set to indicate what error occurred, if any.
+     */
+    template <typename Body, typename Fields, typename Parser>
+    inline void perform(const boost::beast::http::request<Body, Fields>& request, Parser& response_parser,
+                        boost::system::error_code& ec)
+    {
+        perform(request, response_parser, ec, stream_.io_timeout());
+    }
+
+    /**
+     * Perform HTTP request streaming the response body through a callback.
+     * The body is drained through boost::beast::http::buffer_body in chunks of up to
+     * kChunkSize bytes and @p chunk_func is invoked as `chunk_func(const char* data, std::size_t size)`
+     * for each of them, so a multi-GB response passes through with O(kChunkSize) memory.
+     *
+     * @tparam Body Type of the body used in the @p request.
+     * @tparam Fields Type of the fields used in the @p request.
+     * @tparam ChunkFunc Type of the body chunk callback.
+     *
+     * @param[in] request HTTP request to send.
+     * @param[in] chunk_func Callback invoked per received body chunk.
+     * @param[out] ec Set to indicate what error occurred, if any.
+     * @param[in] deadline Expiration time-point.
+     *
+     * @returns Header of received response wrapped in boost::optional or boost::none if an error occurred.
+     */
+    template <typename Body, typename Fields, typename ChunkFunc>
+    boost::optional<boost::beast::http::response_header<>>
+    perform_stream(const boost::beast::http::request<Body, Fields>& request, ChunkFunc&& chunk_func,
+                   boost::system::error_code& ec, const time_point_type& deadline);
+
+    /**
+     * Perform HTTP request streaming the response body through a callback.
+     * Same as above but expires within specified time from now.
+     *
+     * @param[in] request HTTP request to send.
+     * @param[in] chunk_func Callback invoked per received body chunk.
+     * @param[out] ec Set to indicate what error occurred, if any.
+     * @param[in] timeout Expiration duration.
+     *
+     * @returns Header of received response wrapped in boost::optional or boost::none if an error occurred.
+     */
+    template <typename Body, typename Fields, typename ChunkFunc>
+    inline boost::optional<boost::beast::http::response_header<>>
+    perform_stream(const boost::beast::http::request<Body, Fields>& request, ChunkFunc&& chunk_func,
+                   boost::system::error_code& ec, const time_duration_type& timeout)
+    {
+        return perform_stream(request, std::forward<ChunkFunc>(chunk_func), ec, clock_type::now() + timeout);
+    }
+
+    /**
+     * Perform HTTP request streaming the response body through a callback.
+     * Same as above; timeout for this operation is defined by stream's I/O default timeout.
+     *
+     * @param[in] request HTTP request to send.
+     * @param[in] chunk_func Callback invoked per received body chunk.
+     *
+     * @returns Header of received response.
+     * @throws boost::system::system_error Thrown on failure.
+     */
+    template <typename Body, typename Fields, typename ChunkFunc>
+    inline boost::beast::http::response_header<>
+    perform_stream(const boost::beast::http::request<Body, Fields>& request, ChunkFunc&& chunk_func)
+    {
+        boost::system::error_code ec;
+        auto header = perform_stream(request, std::forward<ChunkFunc>(chunk_func), ec, stream_.io_timeout());
+        if (ec) {
+            throw boost::system::system_error{ec};
+        }
+        if (!header) {
+            throw boost::system::system_error{boost::asio::error::operation_aborted};
+        }
+        return *header;
+    }
+
     /**
      * Get a const reference to the underlying stream of type @p Socket
      *
@@ -185,6 +518,28 @@ public:
         return stream_;
     }
 
+    /**
+     * Get a const reference to the lowest layer.
+     *
+     * @returns This function returns a const reference to the lowest layer
+     * in a stack of layers.
+     */
+    inline const lowest_layer_type& lowest_layer() const
+    {
+        return next_layer().lowest_layer();
+    }
+
+    /**
+     * Get a reference to the lowest layer.
+     *
+     * @returns This function returns a reference to the lowest layer
+     * in a stack of layers.
+     */
+    inline lowest_layer_type& lowest_layer()
+    {
+        return next_layer().lowest_layer();
+    }
+
     /// Determine whether the underlying stream is open.
     inline bool is_open() const
     {
@@ -244,8 +599,50 @@ protected:
                                                                               const time_point_type& deadline);
 
 private:
+    /**
+     * Receive single HTTP response without discarding read-ahead data.
+     * Unlike recv_response() bytes already sitting in the shared buffer (read past the
+     * previous response of a pipeline) are parsed first, the stream is read only when
+     * the parser needs more.
+     *
+     * @param[in] deadline Expiration time-point.
+     * @param[out] ec Set to indicate what error occurred, if any.
+     *
+     * @returns Received response wrapped in boost::optional or boost::none if an error occurred.
+     */
+    template <typename Body, typename Fields>
+    boost::optional<boost::beast::http::response<Body, Fields>>
+    recv_pipelined_response(boost::system::error_code& ec, const time_point_type& deadline);
+
+    /**
+     * Receive HTTP response keeping its' raw octets in the shared buffer.
+     * The header is parsed at increasing offsets without consuming the buffer, so a
+     * plain (Content-Length delimited) body can be returned as a view straight into
+     * it. Chunked and EOF-delimited payloads are interleaved with framing, they get
+     * decoded through the parser and parked back into the buffer to give the view
+     * stable backing - one copy, same as plain recv_response().
+     *
+     * @param[in] deadline Expiration time-point.
+     * @param[out] ec Set to indicate what error occurred, if any.
+     *
+     * @returns Received response wrapped in boost::optional or boost::none if an error occurred.
+     */
+    boost::optional<response_view> recv_response_view(boost::system::error_code& ec, const time_point_type& deadline);
+
+    /**
+     * Read another portion of data from the stream into the shared buffer.
+     * EOF is reported as-is via @p ec for the caller to decide on.
+     *
+     * @param[in] deadline Expiration time-point.
+     * @param[out] ec Set to indicate what error occurred, if any.
+     *
+     * @returns Number of bytes committed into the buffer.
+     */
+    std::size_t read_into_buffer(boost::system::error_code& ec, const time_point_type& deadline);
+
     Stream stream_; ///< Stream to perform rw access.
     boost::beast::basic_flat_buffer<allocator_type> buffer_; ///< Buffer to store incoming data.
+    arena_allocator_type header_arena_; ///< Arena for response headers, reset between perform() calls.
 };
 
 //! HTTP stream.
@@ -1,33 +1,89 @@
 #pragma once
 
+#include "stream-client/tracer.hpp"
+
 #include <boost/asio/ip/tcp.hpp>
 #include <boost/asio/socket_base.hpp>
 
+#if defined(__linux__)
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+#endif
+
 namespace stream_client {
 
 template <typename Socket>
 base_socket<Socket>::base_socket(const endpoint_type& peer_endpoint, time_duration_type connect_timeout,
-                                 time_duration_type operation_timeout)
-    : detail::steady_timed_base()
+                                 time_duration_type operation_timeout, socket_profile profile)
+    : base_socket(nullptr, peer_endpoint, std::move(connect_timeout), std::move(operation_timeout),
+                  std::move(profile))
+{
+}
+
+template <typename Socket>
+base_socket<Socket>::base_socket(::stream_client::reactor& io_reactor, const endpoint_type& peer_endpoint,
+                                 time_duration_type connect_timeout, time_duration_type operation_timeout,
+                                 socket_profile profile)
+    : base_socket(&io_reactor, peer_endpoint, std::move(connect_timeout), std::move(operation_timeout),
+                  std::move(profile))
+{
+}
+
+template <typename Socket>
+base_socket<Socket>::base_socket(::stream_client::reactor* io_reactor, const endpoint_type& peer_endpoint,
+                                 time_duration_type connect_timeout, time_duration_type operation_timeout,
+                                 socket_profile profile)
+    : detail::steady_timed_base(io_reactor)
     , socket_(get_io_service())
     , connection_timeout_(std::move(connect_timeout))
     , io_operation_timeout_(std::move(operation_timeout))
+    , profile_(std::move(profile))
 {
+    detail::trace_scope span(trace_phase::connect);
     io_timeout_enabled(false);
-    const auto expiration = scope_expire(connection_timeout_);
+    auto expiration = scope_expire(connection_timeout_);
+
+    if (profile_.tuned()) {
+        // open the socket up-front so the knobs are in place for the handshake
+        // and the first congestion window
+        boost::system::error_code open_ec;
+        socket_.open(peer_endpoint.protocol(), open_ec);
+        if (!open_ec) {
+            apply_profile();
+        }
+    }
+
+#if defined(__linux__) && defined(TCP_FASTOPEN_CONNECT)
+    if (std::is_same<protocol_type, boost::asio::ip::tcp>::value && tcp_fastopen_enabled()) {
+        // open the socket up-front so the option is in place before connect;
+        // with it the SYN is deferred to the first write and carries the payload
+        // when a Fast Open cookie is cached
+        boost::system::error_code fastopen_ec;
+        if (!socket_.is_open()) {
+            socket_.open(peer_endpoint.protocol(), fastopen_ec);
+        }
+        if (!fastopen_ec) {
+            const int enabled = 1;
+            ::setsockopt(socket_.native_handle(), IPPROTO_TCP, TCP_FASTOPEN_CONNECT, &enabled, sizeof(enabled));
+            // a failure here is fine: connect below falls back to the regular handshake
+        }
+    }
+#endif
 
     boost::system::error_code ec = boost::asio::error::would_block;
     socket_.async_connect(peer_endpoint, [&](const boost::system::error_code& error) {
-        if (this->deadline_fired_) {
-            ec = boost::asio::error::timed_out;
-        } else {
-            ec = error;
-        }
+        expiration.reset();
+        this->complete_io([&]() {
+            if (this->deadline_fired_) {
+                ec = boost::asio::error::timed_out;
+            } else {
+                ec = error;
+            }
+        });
     });
-    while (ec == boost::asio::error::would_block) {
-        get_io_service().run_one();
-    };
+    this->wait_io([&ec] { return ec != boost::asio::error::would_block; });
 
+    span.set_error(ec.value());
     if (ec) {
         if (ec == boost::asio::error::timed_out) {
             throw boost::system::system_error{ec, "Socket connection timed out"};
@@ -51,8 +107,34 @@ base_socket<Socket>::base_socket(const endpoint_type& peer_endpoint, time_durati
 
 template <typename Socket>
 base_socket<Socket>::base_socket(const config& cfg)
-    : base_socket(cfg.peer_endpoint, cfg.connect_timeout, cfg.operation_timeout)
+    : base_socket(cfg.io_reactor, cfg.peer_endpoint, cfg.connect_timeout, cfg.operation_timeout, cfg.profile)
+{
+}
+
+template <typename Socket>
+void base_socket<Socket>::apply_profile()
 {
+    // every knob is best-effort: the kernel clamps what it can and rejects what it
+    // cannot, and a missing option must not fail the connect
+    boost::system::error_code ignored_ec;
+    if (profile_.send_buffer_size > 0) {
+        set_option(boost::asio::socket_base::send_buffer_size(profile_.send_buffer_size), ignored_ec);
+    }
+    if (profile_.receive_buffer_size > 0) {
+        set_option(boost::asio::socket_base::receive_buffer_size(profile_.receive_buffer_size), ignored_ec);
+    }
+#if defined(__linux__) && defined(SO_BUSY_POLL)
+    if (profile_.busy_poll_us > 0) {
+        ::setsockopt(socket_.native_handle(), SOL_SOCKET, SO_BUSY_POLL, &profile_.busy_poll_us,
+                     sizeof(profile_.busy_poll_us));
+    }
+#endif
+#if defined(__linux__) && defined(TCP_NOTSENT_LOWAT)
+    if (profile_.notsent_lowat > 0 && std::is_same<protocol_type, boost::asio::ip::tcp>::value) {
+        ::setsockopt(socket_.native_handle(), IPPROTO_TCP, TCP_NOTSENT_LOWAT, &profile_.notsent_lowat,
+                     sizeof(profile_.notsent_lowat));
+    }
+#endif
 }
 
 template <typename Socket>
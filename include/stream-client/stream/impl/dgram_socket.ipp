@@ -3,6 +3,13 @@
 #include <boost/asio/read.hpp>
 #include <boost/asio/write.hpp>
 
+#include <cerrno>
+#include <cstring>
+
+#if defined(__linux__)
+#include <sys/socket.h>
+#endif
+
 namespace stream_client {
 
 template <typename Protocol>
@@ -28,12 +35,9 @@ std::size_t datagram_socket<Protocol>::send(const ConstBufferSequence& buffers,
             setup_expiration);
 
         setup_expiration = false;
-        while (ec == boost::asio::error::would_block) {
-            this->get_io_service().run_one();
-        }
+        this->wait_io([&ec] { return ec != boost::asio::error::would_block; });
     } while (ec == boost::asio::error::try_again);
 
-    this->get_io_service().reset();
     return transfered_bytes;
 }
 
@@ -73,12 +77,9 @@ std::size_t datagram_socket<Protocol>::receive(const MutableBufferSequence& buff
             setup_expiration);
 
         setup_expiration = false;
-        while (ec == boost::asio::error::would_block) {
-            this->get_io_service().run_one();
-        }
+        this->wait_io([&ec] { return ec != boost::asio::error::would_block; });
     } while (ec == boost::asio::error::try_again);
 
-    this->get_io_service().reset();
     return transfered_bytes;
 }
 
@@ -95,6 +96,190 @@ std::size_t datagram_socket<Protocol>::receive(const MutableBufferSequence& buff
     return transfered_bytes;
 }
 
+template <typename Protocol>
+template <typename Time>
+std::size_t datagram_socket<Protocol>::send_batch(const std::vector<boost::asio::const_buffer>& datagrams,
+                                                  boost::system::error_code& ec, const Time& timeout_or_deadline)
+{
+    ec = {};
+    if (datagrams.empty()) {
+        return 0;
+    }
+
+#if defined(__linux__)
+    if (!this->next_layer().native_non_blocking()) {
+        this->next_layer().native_non_blocking(true, ec);
+        if (ec) {
+            return 0;
+        }
+    }
+
+    std::vector<struct mmsghdr> messages(datagrams.size());
+    std::vector<struct iovec> iovecs(datagrams.size());
+    for (std::size_t i = 0; i < datagrams.size(); ++i) {
+        iovecs[i].iov_base = const_cast<void*>(datagrams[i].data());
+        iovecs[i].iov_len = datagrams[i].size();
+        std::memset(&messages[i], 0, sizeof(messages[i]));
+        messages[i].msg_hdr.msg_iov = &iovecs[i];
+        messages[i].msg_hdr.msg_iovlen = 1;
+    }
+
+    std::size_t sent_count = 0;
+    auto expire = this->scope_expire(timeout_or_deadline);
+    while (sent_count < messages.size()) {
+        const int n_sent = ::sendmmsg(this->next_layer().native_handle(), messages.data() + sent_count,
+                                      messages.size() - sent_count, 0);
+        if (n_sent > 0) {
+            sent_count += n_sent;
+            continue;
+        }
+        if (errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR) {
+            ec = boost::system::error_code(errno, boost::system::system_category());
+            break;
+        }
+        // socket buffer is full, wait for writability under the same deadline
+        wait_ready(boost::asio::socket_base::wait_write, ec);
+        if (ec) {
+            break;
+        }
+    }
+    expire.reset();
+    return sent_count;
+#else
+    // portable fallback: one datagram per send()
+    std::size_t sent_count = 0;
+    for (const auto& datagram : datagrams) {
+        send(datagram, ec, timeout_or_deadline);
+        if (ec) {
+            break;
+        }
+        ++sent_count;
+    }
+    return sent_count;
+#endif
+}
+
+template <typename Protocol>
+template <typename Time>
+std::size_t datagram_socket<Protocol>::send_batch(const std::vector<boost::asio::const_buffer>& datagrams,
+                                                  const Time& timeout_or_deadline)
+{
+    boost::system::error_code ec;
+    std::size_t sent_count = send_batch(datagrams, ec, timeout_or_deadline);
+    if (ec) {
+        throw boost::system::system_error{ec, "Socket send_batch() failed"};
+    }
+
+    return sent_count;
+}
+
+template <typename Protocol>
+template <typename Time>
+std::size_t datagram_socket<Protocol>::receive_batch(const std::vector<boost::asio::mutable_buffer>& datagrams,
+                                                     std::vector<std::size_t>& sizes, boost::system::error_code& ec,
+                                                     const Time& timeout_or_deadline)
+{
+    ec = {};
+    sizes.clear();
+    if (datagrams.empty()) {
+        return 0;
+    }
+
+#if defined(__linux__)
+    if (!this->next_layer().native_non_blocking()) {
+        this->next_layer().native_non_blocking(true, ec);
+        if (ec) {
+            return 0;
+        }
+    }
+
+    std::vector<struct mmsghdr> messages(datagrams.size());
+    std::vector<struct iovec> iovecs(datagrams.size());
+    for (std::size_t i = 0; i < datagrams.size(); ++i) {
+        iovecs[i].iov_base = datagrams[i].data();
+        iovecs[i].iov_len = datagrams[i].size();
+        std::memset(&messages[i], 0, sizeof(messages[i]));
+        messages[i].msg_hdr.msg_iov = &iovecs[i];
+        messages[i].msg_hdr.msg_iovlen = 1;
+    }
+
+    std::size_t recv_count = 0;
+    auto expire = this->scope_expire(timeout_or_deadline);
+    while (recv_count == 0) {
+        const int n_recv =
+            ::recvmmsg(this->next_layer().native_handle(), messages.data(), messages.size(), MSG_DONTWAIT, nullptr);
+        if (n_recv > 0) {
+            recv_count = n_recv;
+            break;
+        }
+        if (errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR) {
+            ec = boost::system::error_code(errno, boost::system::system_category());
+            break;
+        }
+        // nothing to read yet, wait for the first datagram under the same deadline
+        wait_ready(boost::asio::socket_base::wait_read, ec);
+        if (ec) {
+            break;
+        }
+    }
+    expire.reset();
+
+    sizes.reserve(recv_count);
+    for (std::size_t i = 0; i < recv_count; ++i) {
+        sizes.push_back(messages[i].msg_len);
+    }
+    return recv_count;
+#else
+    // portable fallback: wait for the first datagram, then drain quickly available ones
+    std::size_t recv_count = 0;
+    for (const auto& datagram : datagrams) {
+        const auto n_bytes = (recv_count == 0) ? receive(datagram, ec, timeout_or_deadline)
+                                               : receive(datagram, ec, this->kMinTimeout);
+        if (ec) {
+            if (recv_count > 0 && ec == boost::asio::error::timed_out) {
+                // no more datagrams immediately available
+                ec = {};
+            }
+            break;
+        }
+        sizes.push_back(n_bytes);
+        ++recv_count;
+    }
+    return recv_count;
+#endif
+}
+
+template <typename Protocol>
+template <typename Time>
+std::size_t datagram_socket<Protocol>::receive_batch(const std::vector<boost::asio::mutable_buffer>& datagrams,
+                                                     std::vector<std::size_t>& sizes, const Time& timeout_or_deadline)
+{
+    boost::system::error_code ec;
+    std::size_t recv_count = receive_batch(datagrams, sizes, ec, timeout_or_deadline);
+    if (ec) {
+        throw boost::system::system_error{ec, "Socket receive_batch() failed"};
+    }
+
+    return recv_count;
+}
+
+template <typename Protocol>
+void datagram_socket<Protocol>::wait_ready(boost::asio::socket_base::wait_type wait_type,
+                                           boost::system::error_code& ec)
+{
+    ec = boost::asio::error::would_block;
+    this->next_layer().async_wait(wait_type, [&](const boost::system::error_code& error) {
+        this->complete_io([&]() {
+            if (this->deadline_fired_) {
+                ec = boost::asio::error::timed_out;
+            } else {
+                ec = error;
+            }
+        });
+    });
+    this->wait_io([&ec] { return ec != boost::asio::error::would_block; });
+}
+
 template <typename Protocol>
 template <typename ConstBufferSequence, typename WriteHandler, typename Time>
 void datagram_socket<Protocol>::async_send(const ConstBufferSequence& buffers, const Time& timeout_or_deadline,
@@ -106,10 +291,12 @@ void datagram_socket<Protocol>::async_send(const ConstBufferSequence& buffers, c
     }
     // clang-format off
     this->next_layer().async_send(
-        buffers, [e = std::move(expire), h = std::forward<WriteHandler>(handler)](const boost::system::error_code& ec,
-                                                                                  std::size_t n_bytes)
+        buffers,
+        [this, e = std::move(expire), h = std::forward<WriteHandler>(handler)](const boost::system::error_code& ec,
+                                                                               std::size_t n_bytes) mutable
         {
-            h(ec, std::move(n_bytes));
+            e.reset();
+            this->complete_io([&]() { h(ec, std::move(n_bytes)); });
         }
     );
     // clang-format on
@@ -126,10 +313,12 @@ void datagram_socket<Protocol>::async_receive(const MutableBufferSequence& buffe
     }
     // clang-format off
     this->next_layer().async_receive(
-        buffers, [e = std::move(expire), h = std::forward<ReadHandler>(handler)](const boost::system::error_code& ec,
-                                                                                 std::size_t n_bytes)
+        buffers,
+        [this, e = std::move(expire), h = std::forward<ReadHandler>(handler)](const boost::system::error_code& ec,
+                                                                              std::size_t n_bytes) mutable
         {
-            h(ec, std::move(n_bytes));
+            e.reset();
+            this->complete_io([&]() { h(ec, std::move(n_bytes)); });
         }
     );
     // clang-format on
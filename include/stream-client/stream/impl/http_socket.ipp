@@ -1,5 +1,7 @@
 #pragma once
 
+#include "stream-client/tracer.hpp"
+
 namespace stream_client {
 namespace http {
 
@@ -7,18 +9,185 @@ template <typename Stream>
 const size_t base_socket<Stream>::kHeaderLimit = 1 << 20; // 1Mb limit
 template <typename Stream>
 const size_t base_socket<Stream>::kBodyLimit = 10 << 20; // 10Mb limit
+template <typename Stream>
+const size_t base_socket<Stream>::kChunkSize = 1 << 16; // 64Kb chunks, same as the read loop
 
 template <typename Stream>
 template <typename Body, typename Fields>
 boost::optional<boost::beast::http::response<Body, Fields>>
 base_socket<Stream>::perform(const boost::beast::http::request<Body, Fields>& request, boost::system::error_code& ec,
                              const time_point_type& deadline)
+{
+    ::stream_client::detail::trace_scope span(::stream_client::trace_phase::request);
+    send_request(request, ec, deadline);
+    if (ec) {
+        span.set_error(ec.value());
+        return boost::none;
+    }
+    auto response = recv_response<Body, Fields>(ec, deadline);
+    span.set_error(ec.value());
+    return response;
+}
+
+template <typename Stream>
+template <typename Body, typename Fields>
+boost::optional<response_view>
+base_socket<Stream>::perform_view(const boost::beast::http::request<Body, Fields>& request,
+                                  boost::system::error_code& ec, const time_point_type& deadline)
+{
+    ::stream_client::detail::trace_scope span(::stream_client::trace_phase::request);
+    send_request(request, ec, deadline);
+    if (ec) {
+        span.set_error(ec.value());
+        return boost::none;
+    }
+    auto response = recv_response_view(ec, deadline);
+    span.set_error(ec.value());
+    return response;
+}
+
+template <typename Stream>
+template <typename Body, typename Fields>
+std::vector<boost::beast::http::response<Body, Fields>>
+base_socket<Stream>::perform_batch(const std::vector<boost::beast::http::request<Body, Fields>>& requests,
+                                   boost::system::error_code& ec, const time_point_type& deadline)
+{
+    std::vector<boost::beast::http::response<Body, Fields>> responses;
+    if (requests.empty()) {
+        return responses;
+    }
+    responses.reserve(requests.size());
+
+    // serialize all requests back-to-back into a single gathered buffer
+    boost::beast::flat_buffer out_buffer;
+    for (const auto& request : requests) {
+        boost::beast::http::request_serializer<Body, Fields> serializer(request);
+        serializer.split(false);
+        while (!serializer.is_done()) {
+            std::size_t n_bytes = 0;
+            serializer.next(ec, [&out_buffer, &n_bytes](boost::system::error_code& ec, const auto& buffers) {
+                n_bytes = boost::asio::buffer_size(buffers);
+                out_buffer.commit(boost::asio::buffer_copy(out_buffer.prepare(n_bytes), buffers));
+                ec = {};
+            });
+            if (ec) {
+                return responses;
+            }
+            serializer.consume(n_bytes);
+        }
+    }
+
+    // push the whole pipeline with as few writes as the socket allows
+    while (out_buffer.size() > 0) {
+        const auto n_bytes = stream_.write_some(out_buffer.data(), ec, deadline);
+        if (ec) {
+            return responses;
+        }
+        out_buffer.consume(n_bytes);
+    }
+
+    // responses come back in request order
+    buffer_.consume(buffer_.size());
+    for (std::size_t i = 0; i < requests.size(); ++i) {
+        auto response = recv_pipelined_response<Body, Fields>(ec, deadline);
+        if (ec || !response) {
+            break;
+        }
+        responses.emplace_back(std::move(*response));
+    }
+    return responses;
+}
+
+template <typename Stream>
+template <typename Body, typename Fields, typename Parser>
+void base_socket<Stream>::perform(const boost::beast::http::request<Body, Fields>& request, Parser& response_parser,
+                                  boost::system::error_code& ec, const time_point_type& deadline)
+{
+    send_request(request, ec, deadline);
+    if (ec) {
+        return;
+    }
+
+    buffer_.consume(buffer_.size());
+    recv_response(response_parser, buffer_, ec, deadline);
+}
+
+template <typename Stream>
+template <typename Body, typename Fields, typename ChunkFunc>
+boost::optional<boost::beast::http::response_header<>>
+base_socket<Stream>::perform_stream(const boost::beast::http::request<Body, Fields>& request, ChunkFunc&& chunk_func,
+                                    boost::system::error_code& ec, const time_point_type& deadline)
 {
     send_request(request, ec, deadline);
     if (ec) {
         return boost::none;
     }
-    return recv_response<Body, Fields>(ec, deadline);
+
+    boost::beast::http::response_parser<boost::beast::http::buffer_body> parser;
+    parser.header_limit(kHeaderLimit);
+    // the body never lands in memory, it is drained through chunk_func
+    parser.body_limit(boost::none);
+    parser.eager(true);
+
+    std::vector<char> chunk(kChunkSize);
+    buffer_.consume(buffer_.size());
+    bool read_more = true;
+    while (!parser.is_done()) {
+        if (read_more) {
+            // obtain writable buffer sequence
+            boost::optional<typename decltype(buffer_)::mutable_buffers_type> out_buff;
+            const auto read_size = std::min<std::size_t>(kChunkSize, buffer_.max_size() - buffer_.size() - 1);
+            try {
+                out_buff.emplace(buffer_.prepare(read_size));
+            } catch (const std::length_error&) {
+                ec = boost::beast::http::error::buffer_overflow;
+                return boost::none;
+            }
+            // read data from stream into writable buffer
+            const auto recv_bytes = stream_.read_some(*out_buff, ec, deadline);
+            if (ec == boost::asio::error::eof) {
+                if (parser.got_some()) {
+                    // caller sees EOF on next read
+                    parser.put_eof(ec);
+                    if (!ec) {
+                        continue;
+                    }
+                } else {
+                    ec = boost::beast::http::error::end_of_stream;
+                }
+            }
+            if (ec) {
+                return boost::none;
+            }
+            // commit written data from writable buffer to readable one
+            buffer_.commit(recv_bytes);
+        }
+
+        // parse data from readable buffer into the chunk and hand it over
+        parser.get().body().data = chunk.data();
+        parser.get().body().size = chunk.size();
+        buffer_.consume(parser.put(buffer_.data(), ec));
+        const std::size_t chunk_bytes = chunk.size() - parser.get().body().size;
+        if (chunk_bytes) {
+            chunk_func(static_cast<const char*>(chunk.data()), chunk_bytes);
+        }
+
+        if (ec == boost::beast::http::error::need_more) {
+            // incomplete message, read the rest of it
+            ec = {};
+            read_more = true;
+        } else if (ec == boost::beast::http::error::need_buffer) {
+            // the chunk has been filled up, flushed above; drain the leftovers first
+            ec = {};
+            read_more = (buffer_.size() == 0);
+        } else if (ec) {
+            return boost::none;
+        } else {
+            read_more = (buffer_.size() == 0);
+        }
+    }
+
+    return boost::beast::http::response_header<>(parser.release());
 }
 
 template <typename Stream>
@@ -93,17 +262,224 @@ template <typename Body, typename Fields>
 boost::optional<boost::beast::http::response<Body, Fields>>
 base_socket<Stream>::recv_response(boost::system::error_code& ec, const time_point_type& deadline)
 {
-    boost::beast::http::response_parser<Body, typename Fields::allocator_type> parser;
+    // drop stale bytes of previous interactions; with an empty buffer
+    // pipelined receive degenerates into a plain one
+    buffer_.consume(buffer_.size());
+    return recv_pipelined_response<Body, Fields>(ec, deadline);
+}
+
+template <typename Stream>
+template <typename Body, typename Fields>
+boost::optional<boost::beast::http::response<Body, Fields>>
+base_socket<Stream>::recv_pipelined_response(boost::system::error_code& ec, const time_point_type& deadline)
+{
+    // headers are allocated from the per-socket arena; it resets itself once the parser is gone
+    boost::beast::http::response_parser<Body, arena_allocator_type> parser(std::piecewise_construct, std::make_tuple(),
+                                                                           std::make_tuple(header_arena_));
     parser.header_limit(kHeaderLimit);
     parser.body_limit(kBodyLimit);
     parser.eager(true);
 
+    try {
+        while (!parser.is_done()) {
+            if (buffer_.size() > 0) {
+                // parse bytes already read ahead before touching the stream
+                buffer_.consume(parser.put(buffer_.data(), ec));
+                if (ec == boost::beast::http::error::need_more) {
+                    ec = {};
+                } else if (ec) {
+                    return boost::none;
+                } else {
+                    continue;
+                }
+            }
+
+            // obtain writable buffer sequence
+            boost::optional<typename decltype(buffer_)::mutable_buffers_type> out_buff;
+            const auto read_size = std::min<std::size_t>(65536, buffer_.max_size() - buffer_.size() - 1);
+            try {
+                out_buff.emplace(buffer_.prepare(read_size));
+            } catch (const std::length_error&) {
+                ec = boost::beast::http::error::buffer_overflow;
+                return boost::none;
+            }
+            // read data from stream into writable buffer
+            const auto recv_bytes = stream_.read_some(*out_buff, ec, deadline);
+            if (ec == boost::asio::error::eof) {
+                if (parser.got_some()) {
+                    // caller sees EOF on next read
+                    parser.put_eof(ec);
+                    if (!ec) {
+                        continue;
+                    }
+                } else {
+                    ec = boost::beast::http::error::end_of_stream;
+                }
+            }
+            if (ec) {
+                return boost::none;
+            }
+            // commit written data from writable buffer to readable one
+            buffer_.commit(recv_bytes);
+        }
+    } catch (const std::bad_alloc&) {
+        // the header arena has been exhausted
+        ec = boost::beast::http::error::header_limit;
+        return boost::none;
+    }
+
+    // copy the response out of the arena so the result owns its' memory
+    auto arena_response = parser.release();
+    boost::beast::http::response<Body, Fields> response;
+    static_cast<Fields&>(response) = arena_response;
+    response.version(arena_response.version());
+    response.result(arena_response.result_int());
+    // result() resets the reason to the status' default phrase, restore the one from the wire
+    response.reason(arena_response.reason());
+    response.body() = std::move(arena_response.body());
+    return response;
+}
+
+template <typename Stream>
+boost::optional<response_view> base_socket<Stream>::recv_response_view(boost::system::error_code& ec,
+                                                                       const time_point_type& deadline)
+{
+    // the result references buffer_, so whatever it held before goes away now
     buffer_.consume(buffer_.size());
-    recv_response(parser, buffer_, ec, deadline);
+
+    boost::beast::http::response_parser<boost::beast::http::buffer_body> parser;
+    parser.header_limit(kHeaderLimit);
+    parser.body_limit(kBodyLimit);
+
+    // octets of buffer_ past what the parser has already seen
+    const auto unparsed_tail = [this](std::size_t parsed_bytes) {
+        const auto readable = buffer_.data();
+        return boost::asio::const_buffer(static_cast<const char*>(readable.data()) + parsed_bytes,
+                                         readable.size() - parsed_bytes);
+    };
+
+    // parse the header feeding bytes at increasing offsets, never consuming them,
+    // so the raw octets stay in buffer_ to back the returned view
+    std::size_t parsed_bytes = 0;
+    while (!parser.is_header_done()) {
+        if (parsed_bytes < buffer_.size()) {
+            parsed_bytes += parser.put(unparsed_tail(parsed_bytes), ec);
+            if (ec == boost::beast::http::error::need_more) {
+                ec = {};
+            } else if (ec) {
+                return boost::none;
+            } else {
+                continue;
+            }
+        }
+        read_into_buffer(ec, deadline);
+        if (ec == boost::asio::error::eof) {
+            // a valid response cannot end inside its' header
+            ec = parser.got_some() ? boost::beast::http::error::partial_message
+                                   : boost::beast::http::error::end_of_stream;
+        }
+        if (ec) {
+            return boost::none;
+        }
+    }
+
+    response_view response;
+
+    if (!parser.chunked() && parser.content_length()) {
+        if (*parser.content_length() > kBodyLimit) {
+            ec = boost::beast::http::error::body_limit;
+            return boost::none;
+        }
+        // plain transfer: the body is the raw octets right past the header,
+        // read the remainder in and point at it - no decoding, no copy
+        const auto body_size = static_cast<std::size_t>(*parser.content_length());
+        while (buffer_.size() - parsed_bytes < body_size) {
+            read_into_buffer(ec, deadline);
+            if (ec == boost::asio::error::eof) {
+                ec = boost::beast::http::error::partial_message;
+            }
+            if (ec) {
+                return boost::none;
+            }
+        }
+        response.header = parser.get().base();
+        response.body =
+            boost::beast::string_view(static_cast<const char*>(buffer_.data().data()) + parsed_bytes, body_size);
+        return response;
+    }
+
+    // chunked (or EOF-delimited) payload is interleaved with framing and cannot be
+    // viewed in place; decode it through the parser and park the decoded bytes back
+    // into buffer_ to give the view stable backing - one copy, same as recv_response()
+    parser.eager(true);
+    std::string decoded;
+    std::vector<char> chunk(kChunkSize);
+    while (!parser.is_done()) {
+        bool read_more = true;
+        if (parsed_bytes < buffer_.size()) {
+            parser.get().body().data = chunk.data();
+            parser.get().body().size = chunk.size();
+            parsed_bytes += parser.put(unparsed_tail(parsed_bytes), ec);
+            const std::size_t chunk_bytes = chunk.size() - parser.get().body().size;
+            if (chunk_bytes) {
+                decoded.append(chunk.data(), chunk_bytes);
+            }
+            if (ec == boost::beast::http::error::need_more) {
+                // incomplete message, read the rest of it
+                ec = {};
+            } else if (ec == boost::beast::http::error::need_buffer) {
+                // the chunk has been filled up, flushed above; drain the leftovers first
+                ec = {};
+                read_more = false;
+            } else if (ec) {
+                return boost::none;
+            } else {
+                read_more = false;
+            }
+        }
+        if (!read_more) {
+            continue;
+        }
+        read_into_buffer(ec, deadline);
+        if (ec == boost::asio::error::eof) {
+            // EOF delimits the body of a response without a length
+            parser.put_eof(ec);
+        }
+        if (ec) {
+            return boost::none;
+        }
+    }
+
+    // trailers (if any) arrived during the body parse, capture the header afterwards
+    response.header = parser.get().base();
+    if (!decoded.empty()) {
+        buffer_.consume(buffer_.size());
+        buffer_.commit(boost::asio::buffer_copy(buffer_.prepare(decoded.size()), boost::asio::buffer(decoded)));
+        response.body = boost::beast::string_view(static_cast<const char*>(buffer_.data().data()), decoded.size());
+    }
+    return response;
+}
+
+template <typename Stream>
+std::size_t base_socket<Stream>::read_into_buffer(boost::system::error_code& ec, const time_point_type& deadline)
+{
+    // obtain writable buffer sequence
+    boost::optional<typename boost::beast::basic_flat_buffer<allocator_type>::mutable_buffers_type> out_buff;
+    const auto read_size = std::min<std::size_t>(65536, buffer_.max_size() - buffer_.size() - 1);
+    try {
+        out_buff.emplace(buffer_.prepare(read_size));
+    } catch (const std::length_error&) {
+        ec = boost::beast::http::error::buffer_overflow;
+        return 0;
+    }
+    // read data from stream into writable buffer
+    const auto recv_bytes = stream_.read_some(*out_buff, ec, deadline);
     if (ec) {
-        return boost::none;
+        return 0;
     }
-    return parser.get();
+    // commit written data from writable buffer to readable one
+    buffer_.commit(recv_bytes);
+    return recv_bytes;
 }
 
 } // namespace http
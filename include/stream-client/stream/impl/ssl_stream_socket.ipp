@@ -1,25 +1,50 @@
 #pragma once
 
+#include "stream-client/tracer.hpp"
+
 namespace stream_client {
 namespace ssl {
 
 template <typename Socket>
 stream_socket<Socket>::stream_socket(const endpoint_type& peer_endpoint, time_duration_type connect_timeout,
                                      time_duration_type operation_timeout, const std::string& upstream_host,
-                                     bool rfc2818_handshake)
-    : ssl_context_(boost::asio::ssl::context::sslv23)
+                                     bool rfc2818_handshake, ::stream_client::socket_profile profile)
+    : stream_socket(nullptr, peer_endpoint, std::move(connect_timeout), std::move(operation_timeout), upstream_host,
+                    rfc2818_handshake, std::move(profile))
+{
+}
+
+template <typename Socket>
+stream_socket<Socket>::stream_socket(::stream_client::reactor& io_reactor, const endpoint_type& peer_endpoint,
+                                     time_duration_type connect_timeout, time_duration_type operation_timeout,
+                                     const std::string& upstream_host, bool rfc2818_handshake,
+                                     ::stream_client::socket_profile profile)
+    : stream_socket(&io_reactor, peer_endpoint, std::move(connect_timeout), std::move(operation_timeout), upstream_host,
+                    rfc2818_handshake, std::move(profile))
+{
+}
+
+template <typename Socket>
+stream_socket<Socket>::stream_socket(::stream_client::reactor* io_reactor, const endpoint_type& peer_endpoint,
+                                     time_duration_type connect_timeout, time_duration_type operation_timeout,
+                                     const std::string& upstream_host, bool rfc2818_handshake,
+                                     ::stream_client::socket_profile profile)
+    : ssl_context_(detail::ssl_session_cache::instance().shared_context())
+    , upstream_host_(upstream_host)
 {
     const auto deadline = clock_type::now() + connect_timeout;
 
-    ssl_context_.set_default_verify_paths();
     ssl_stream_ = std::make_unique<ssl_layer_type>(next_layer_config{peer_endpoint, std::move(connect_timeout),
-                                                                     std::move(operation_timeout)},
-                                                   ssl_context_);
+                                                                     std::move(operation_timeout), io_reactor,
+                                                                     std::move(profile)},
+                                                   *ssl_context_);
 
     if (!SSL_set_tlsext_host_name(ssl_stream_->native_handle(), upstream_host.c_str())) {
         boost::system::error_code ec{static_cast<int>(::ERR_get_error()), boost::asio::error::get_ssl_category()};
         throw boost::system::system_error{ec};
     }
+    // resume the last session negotiated with this host, if any
+    detail::ssl_session_cache::instance().attach(ssl_stream_->native_handle(), upstream_host_);
 
     if (rfc2818_handshake) {
         ssl_stream_->set_verify_mode(boost::asio::ssl::verify_peer);
@@ -34,6 +59,9 @@ boost::system::error_code stream_socket<Socket>::close()
     boost::system::error_code ec;
 
     ssl_layer().shutdown(ec);
+    // TLS 1.3 tickets arrive after the handshake and are consumed by reads,
+    // so the freshest resumable session is the one present at shutdown
+    detail::ssl_session_cache::instance().store(native_handle(), upstream_host_);
 // http://stackoverflow.com/questions/25587403/boost-asio-ssl-async-shutdown-always-finishes-with-an-error
 #if BOOST_VERSION >= 106200
     bool ssl_short_read_err = (ec.value() == boost::asio::ssl::error::stream_truncated);
@@ -57,12 +85,17 @@ template <typename Time>
 boost::system::error_code stream_socket<Socket>::handshake(boost::system::error_code& ec,
                                                            const Time& timeout_or_deadline)
 {
+    ::stream_client::detail::trace_scope span(::stream_client::trace_phase::tls_handshake);
     bool orig_io_timeout_mode = io_timeout_enabled(false);
     const auto expire = scope_expire(timeout_or_deadline);
 
     auto err = ssl_layer().handshake(boost::asio::ssl::stream_base::client, ec);
+    if (!err) {
+        detail::ssl_session_cache::instance().store(native_handle(), upstream_host_);
+    }
 
     io_timeout_enabled(orig_io_timeout_mode);
+    span.set_error(ec.value());
     return err;
 }
 
@@ -77,6 +110,65 @@ void stream_socket<Socket>::handshake(const Time& timeout_or_deadline)
     }
 }
 
+template <typename Socket>
+template <typename Time>
+std::size_t stream_socket<Socket>::handshake_with_early_data(const boost::asio::const_buffer& data,
+                                                             boost::system::error_code& ec,
+                                                             const Time& timeout_or_deadline)
+{
+    ec = {};
+    std::size_t early_bytes = 0;
+
+#if OPENSSL_VERSION_NUMBER >= 0x10101000L
+    SSL* ssl_handle = native_handle();
+    SSL_SESSION* resumable = ::SSL_get_session(ssl_handle);
+    if (data.size() > 0 && resumable != nullptr && ::SSL_SESSION_get_max_early_data(resumable) > 0) {
+        // writes ClientHello plus the payload into the engine's output BIO;
+        // the handshake below flushes both to the wire in a single flight
+        size_t written = 0;
+        const int early_result = ::SSL_write_early_data(ssl_handle, data.data(), data.size(), &written);
+        if (early_result == 1) {
+            early_bytes = written;
+        } else {
+            // the state machine falls back to a regular handshake below
+            ::ERR_clear_error();
+        }
+    }
+#endif
+
+    handshake(ec, timeout_or_deadline);
+    if (ec) {
+        return 0;
+    }
+
+#if OPENSSL_VERSION_NUMBER >= 0x10101000L
+    if (early_bytes > 0 && ::SSL_get_early_data_status(ssl_handle) != SSL_EARLY_DATA_ACCEPTED) {
+        // server discarded the early flight, the payload has to be resent in full
+        early_bytes = 0;
+    }
+#endif
+
+    if (early_bytes < data.size()) {
+        const boost::asio::const_buffer rest(static_cast<const char*>(data.data()) + early_bytes,
+                                             data.size() - early_bytes);
+        early_bytes += send(rest, ec, timeout_or_deadline);
+    }
+    return early_bytes;
+}
+
+template <typename Socket>
+template <typename Time>
+std::size_t stream_socket<Socket>::handshake_with_early_data(const boost::asio::const_buffer& data,
+                                                             const Time& timeout_or_deadline)
+{
+    boost::system::error_code ec;
+    const auto sent_bytes = handshake_with_early_data(data, ec, timeout_or_deadline);
+    if (ec) {
+        throw boost::system::system_error(ec);
+    }
+    return sent_bytes;
+}
+
 template <typename Socket>
 template <typename ConstBufferSequence>
 std::size_t stream_socket<Socket>::send(const ConstBufferSequence& buffers, boost::system::error_code& ec,
@@ -3,6 +3,16 @@
 #include <boost/asio/read.hpp>
 #include <boost/asio/write.hpp>
 
+#include <algorithm>
+#include <cerrno>
+#include <vector>
+
+#if defined(__linux__)
+#include <sys/sendfile.h>
+#else
+#include <unistd.h>
+#endif
+
 namespace stream_client {
 
 template <typename Protocol>
@@ -24,6 +34,10 @@ template <typename ConstBufferSequence, typename Time>
 std::size_t stream_socket<Protocol>::send(const ConstBufferSequence& buffers, boost::system::error_code& ec,
                                           const Time& timeout_or_deadline)
 {
+    if (io_fast_path_) {
+        return fast_send(buffers, ec, timeout_or_deadline);
+    }
+
     std::size_t transfered_bytes = 0;
     bool setup_expiration = true;
 
@@ -42,12 +56,9 @@ std::size_t stream_socket<Protocol>::send(const ConstBufferSequence& buffers, bo
             setup_expiration);
 
         setup_expiration = false;
-        while (ec == boost::asio::error::would_block) {
-            this->get_io_service().run_one();
-        }
+        this->wait_io([&ec] { return ec != boost::asio::error::would_block; });
     } while (ec == boost::asio::error::try_again);
 
-    this->get_io_service().reset();
     return transfered_bytes;
 }
 
@@ -64,11 +75,103 @@ std::size_t stream_socket<Protocol>::send(const ConstBufferSequence& buffers, co
     return transfered_bytes;
 }
 
+template <typename Protocol>
+template <typename Time>
+std::size_t stream_socket<Protocol>::send_file(int fd, std::uint64_t offset, std::size_t length,
+                                               boost::system::error_code& ec, const Time& timeout_or_deadline)
+{
+    ec = {};
+    if (length == 0) {
+        return 0;
+    }
+
+#if defined(__linux__)
+    if (!this->next_layer().native_non_blocking()) {
+        this->next_layer().native_non_blocking(true, ec);
+        if (ec) {
+            return 0;
+        }
+    }
+
+    std::size_t sent_bytes = 0;
+    off_t file_offset = static_cast<off_t>(offset);
+    auto expire = this->scope_expire(timeout_or_deadline);
+    while (sent_bytes < length) {
+        const ssize_t n_sent =
+            ::sendfile(this->next_layer().native_handle(), fd, &file_offset, length - sent_bytes);
+        if (n_sent > 0) {
+            sent_bytes += static_cast<std::size_t>(n_sent);
+            continue;
+        }
+        if (n_sent == 0) {
+            // the file ended before length bytes were sent
+            ec = boost::asio::error::eof;
+            break;
+        }
+        if (errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR) {
+            ec = boost::system::error_code(errno, boost::system::system_category());
+            break;
+        }
+        // socket buffer is full, wait for writability under the same deadline
+        wait_ready(boost::asio::socket_base::wait_write, ec);
+        if (ec) {
+            break;
+        }
+    }
+    expire.reset();
+    return sent_bytes;
+#else
+    // portable fallback: copy through a bounded user-space chunk
+    std::vector<char> chunk(64 * 1024);
+    std::size_t sent_bytes = 0;
+    while (sent_bytes < length) {
+        const std::size_t to_read = std::min(chunk.size(), length - sent_bytes);
+        const ssize_t n_read = ::pread(fd, chunk.data(), to_read, static_cast<off_t>(offset + sent_bytes));
+        if (n_read == 0) {
+            // the file ended before length bytes were sent
+            ec = boost::asio::error::eof;
+            break;
+        }
+        if (n_read < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            ec = boost::system::error_code(errno, boost::system::system_category());
+            break;
+        }
+        sent_bytes += send(boost::asio::buffer(chunk.data(), static_cast<std::size_t>(n_read)), ec,
+                           timeout_or_deadline);
+        if (ec) {
+            break;
+        }
+    }
+    return sent_bytes;
+#endif
+}
+
+template <typename Protocol>
+template <typename Time>
+std::size_t stream_socket<Protocol>::send_file(int fd, std::uint64_t offset, std::size_t length,
+                                               const Time& timeout_or_deadline)
+{
+    boost::system::error_code ec;
+    std::size_t sent_bytes = send_file(fd, offset, length, ec, timeout_or_deadline);
+    if (ec) {
+        throw boost::system::system_error{ec, "Socket send_file() failed"};
+    }
+
+    return sent_bytes;
+}
+
 template <typename Protocol>
 template <typename MutableBufferSequence, typename Time>
 std::size_t stream_socket<Protocol>::receive(const MutableBufferSequence& buffers, boost::system::error_code& ec,
                                              const Time& timeout_or_deadline)
 {
+    if (io_fast_path_) {
+        return fast_receive(buffers, ec, timeout_or_deadline);
+    }
+
     std::size_t transfered_bytes = 0;
     bool setup_expiration = true;
 
@@ -87,12 +190,9 @@ std::size_t stream_socket<Protocol>::receive(const MutableBufferSequence& buffer
             setup_expiration);
 
         setup_expiration = false;
-        while (ec == boost::asio::error::would_block) {
-            this->get_io_service().run_one();
-        }
+        this->wait_io([&ec] { return ec != boost::asio::error::would_block; });
     } while (ec == boost::asio::error::try_again);
 
-    this->get_io_service().reset();
     return transfered_bytes;
 }
 
@@ -114,6 +214,18 @@ template <typename ConstBufferSequence, typename Time>
 std::size_t stream_socket<Protocol>::write_some(const ConstBufferSequence& buffers, boost::system::error_code& ec,
                                                 const Time& timeout_or_deadline)
 {
+    if (io_fast_path_) {
+        // the socket is in non-blocking mode: if it is writable this completes in one syscall
+        boost::system::error_code fast_ec;
+        const std::size_t n_bytes = this->next_layer().write_some(buffers, fast_ec);
+        if (fast_ec != boost::asio::error::would_block && fast_ec != boost::asio::error::try_again &&
+            fast_ec != boost::asio::error::interrupted) {
+            ec = fast_ec;
+            return n_bytes;
+        }
+        // it would block - fall back to the timed reactor path below
+    }
+
     std::size_t transfered_bytes = 0;
     ec = boost::asio::error::would_block;
 
@@ -126,10 +238,7 @@ std::size_t stream_socket<Protocol>::write_some(const ConstBufferSequence& buffe
         }
     });
 
-    while (ec == boost::asio::error::would_block) {
-        this->get_io_service().run_one();
-    };
-    this->get_io_service().reset();
+    this->wait_io([&ec] { return ec != boost::asio::error::would_block; });
     return transfered_bytes;
 }
 
@@ -151,6 +260,18 @@ template <typename MutableBufferSequence, typename Time>
 std::size_t stream_socket<Protocol>::read_some(const MutableBufferSequence& buffers, boost::system::error_code& ec,
                                                const Time& timeout_or_deadline)
 {
+    if (io_fast_path_) {
+        // the socket is in non-blocking mode: if data is already buffered this completes in one syscall
+        boost::system::error_code fast_ec;
+        const std::size_t n_bytes = this->next_layer().read_some(buffers, fast_ec);
+        if (fast_ec != boost::asio::error::would_block && fast_ec != boost::asio::error::try_again &&
+            fast_ec != boost::asio::error::interrupted) {
+            ec = fast_ec;
+            return n_bytes;
+        }
+        // nothing to read yet - fall back to the timed reactor path below
+    }
+
     std::size_t transfered_bytes = 0;
     ec = boost::asio::error::would_block;
 
@@ -163,10 +284,7 @@ std::size_t stream_socket<Protocol>::read_some(const MutableBufferSequence& buff
         }
     });
 
-    while (ec == boost::asio::error::would_block) {
-        this->get_io_service().run_one();
-    };
-    this->get_io_service().reset();
+    this->wait_io([&ec] { return ec != boost::asio::error::would_block; });
     return transfered_bytes;
 }
 
@@ -183,6 +301,125 @@ std::size_t stream_socket<Protocol>::read_some(const MutableBufferSequence& buff
     return transfered_bytes;
 }
 
+template <typename Protocol>
+template <typename ConstBufferSequence, typename Time>
+std::size_t stream_socket<Protocol>::fast_send(const ConstBufferSequence& buffers, boost::system::error_code& ec,
+                                               const Time& timeout_or_deadline)
+{
+    ec = {};
+    const std::size_t total_size = boost::asio::buffer_size(buffers);
+    std::vector<boost::asio::const_buffer> pending(boost::asio::buffer_sequence_begin(buffers),
+                                                   boost::asio::buffer_sequence_end(buffers));
+    std::size_t sent_bytes = 0;
+    // the deadline timer is armed lazily, only once the socket actually blocks
+    typename stream_socket<Protocol>::expiration expire;
+    bool expire_armed = false;
+
+    while (sent_bytes < total_size) {
+        boost::system::error_code op_ec;
+        const std::size_t n_bytes = this->next_layer().write_some(pending, op_ec);
+        if (n_bytes > 0) {
+            sent_bytes += n_bytes;
+            consume_buffers(pending, n_bytes);
+            continue;
+        }
+        if (op_ec == boost::asio::error::interrupted) {
+            continue;
+        }
+        if (op_ec != boost::asio::error::would_block && op_ec != boost::asio::error::try_again) {
+            ec = op_ec;
+            break;
+        }
+        // socket buffer is full, wait for writability on the reactor under the deadline
+        if (!expire_armed) {
+            expire = this->scope_expire(timeout_or_deadline);
+            expire_armed = true;
+        }
+        wait_ready(boost::asio::socket_base::wait_write, ec);
+        if (ec) {
+            break;
+        }
+    }
+    expire.reset();
+    return sent_bytes;
+}
+
+template <typename Protocol>
+template <typename MutableBufferSequence, typename Time>
+std::size_t stream_socket<Protocol>::fast_receive(const MutableBufferSequence& buffers, boost::system::error_code& ec,
+                                                  const Time& timeout_or_deadline)
+{
+    ec = {};
+    const std::size_t total_size = boost::asio::buffer_size(buffers);
+    std::vector<boost::asio::mutable_buffer> pending(boost::asio::buffer_sequence_begin(buffers),
+                                                     boost::asio::buffer_sequence_end(buffers));
+    std::size_t received_bytes = 0;
+    // the deadline timer is armed lazily, only once the socket actually blocks
+    typename stream_socket<Protocol>::expiration expire;
+    bool expire_armed = false;
+
+    while (received_bytes < total_size) {
+        boost::system::error_code op_ec;
+        const std::size_t n_bytes = this->next_layer().read_some(pending, op_ec);
+        if (n_bytes > 0) {
+            received_bytes += n_bytes;
+            consume_buffers(pending, n_bytes);
+            continue;
+        }
+        if (op_ec == boost::asio::error::interrupted) {
+            continue;
+        }
+        if (op_ec != boost::asio::error::would_block && op_ec != boost::asio::error::try_again) {
+            ec = op_ec;
+            break;
+        }
+        // nothing buffered, wait for readability on the reactor under the deadline
+        if (!expire_armed) {
+            expire = this->scope_expire(timeout_or_deadline);
+            expire_armed = true;
+        }
+        wait_ready(boost::asio::socket_base::wait_read, ec);
+        if (ec) {
+            break;
+        }
+    }
+    expire.reset();
+    return received_bytes;
+}
+
+template <typename Protocol>
+template <typename BufferType>
+void stream_socket<Protocol>::consume_buffers(std::vector<BufferType>& pending, std::size_t consumed)
+{
+    // advance buffers in place instead of erasing them: fully consumed ones become
+    // zero-length entries, which vectored I/O skips; erase() on the vector also trips
+    // -Warray-bounds false positives on GCC 12
+    for (auto& buffer : pending) {
+        if (consumed == 0) {
+            break;
+        }
+        const std::size_t step = std::min(consumed, buffer.size());
+        buffer = buffer + step;
+        consumed -= step;
+    }
+}
+
+template <typename Protocol>
+void stream_socket<Protocol>::wait_ready(boost::asio::socket_base::wait_type wait_type, boost::system::error_code& ec)
+{
+    ec = boost::asio::error::would_block;
+    this->next_layer().async_wait(wait_type, [&](const boost::system::error_code& error) {
+        this->complete_io([&]() {
+            if (this->deadline_fired_) {
+                ec = boost::asio::error::timed_out;
+            } else {
+                ec = error;
+            }
+        });
+    });
+    this->wait_io([&ec] { return ec != boost::asio::error::would_block; });
+}
+
 template <typename Protocol>
 template <typename ConstBufferSequence, typename WriteHandler, typename Time>
 void stream_socket<Protocol>::async_send(const ConstBufferSequence& buffers, const Time& timeout_or_deadline,
@@ -195,10 +432,11 @@ void stream_socket<Protocol>::async_send(const ConstBufferSequence& buffers, con
     // clang-format off
     boost::asio::async_write(
         this->next_layer(), buffers,
-        [e = std::move(expire), h = std::forward<WriteHandler>(handler)](const boost::system::error_code& ec,
-                                                                         std::size_t n_bytes)
+        [this, e = std::move(expire), h = std::forward<WriteHandler>(handler)](const boost::system::error_code& ec,
+                                                                               std::size_t n_bytes) mutable
         {
-            h(ec, std::move(n_bytes));
+            e.reset();
+            this->complete_io([&]() { h(ec, std::move(n_bytes)); });
         }
     );
     // clang-format on
@@ -216,10 +454,11 @@ void stream_socket<Protocol>::async_receive(const MutableBufferSequence& buffers
     // clang-format off
     boost::asio::async_read(
         this->next_layer(), buffers,
-        [e = std::move(expire), h = std::forward<ReadHandler>(handler)](const boost::system::error_code& ec,
-                                                                        std::size_t n_bytes)
+        [this, e = std::move(expire), h = std::forward<ReadHandler>(handler)](const boost::system::error_code& ec,
+                                                                              std::size_t n_bytes) mutable
         {
-            h(ec, std::move(n_bytes));
+            e.reset();
+            this->complete_io([&]() { h(ec, std::move(n_bytes)); });
         }
     );
     // clang-format on
@@ -233,10 +472,12 @@ void stream_socket<Protocol>::async_write_some(const ConstBufferSequence& buffer
     auto expire = this->scope_expire(timeout_or_deadline);
     // clang-format off
     this->next_layer().async_write_some(
-        buffers, [e = std::move(expire), h = std::forward<WriteHandler>(handler)](const boost::system::error_code& ec,
-                                                                                  std::size_t n_bytes)
+        buffers,
+        [this, e = std::move(expire), h = std::forward<WriteHandler>(handler)](const boost::system::error_code& ec,
+                                                                               std::size_t n_bytes) mutable
         {
-            h(ec, std::move(n_bytes));
+            e.reset();
+            this->complete_io([&]() { h(ec, std::move(n_bytes)); });
         }
     );
     // clang-format on
@@ -250,10 +491,12 @@ void stream_socket<Protocol>::async_read_some(const MutableBufferSequence& buffe
     auto expire = this->scope_expire(timeout_or_deadline);
     // clang-format off
     this->next_layer().async_read_some(
-        buffers, [e = std::move(expire), h = std::forward<ReadHandler>(handler)](const boost::system::error_code& ec,
-                                                                                 std::size_t n_bytes)
+        buffers,
+        [this, e = std::move(expire), h = std::forward<ReadHandler>(handler)](const boost::system::error_code& ec,
+                                                                              std::size_t n_bytes) mutable
         {
-            h(ec, std::move(n_bytes));
+            e.reset();
+            this->complete_io([&]() { h(ec, std::move(n_bytes)); });
         }
     );
     // clang-format on
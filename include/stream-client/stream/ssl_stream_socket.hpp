@@ -1,5 +1,6 @@
 #pragma once
 
+#include "detail/ssl_session_cache.hpp"
 #include "stream_socket.hpp"
 
 #include <boost/asio/ssl/context.hpp>
@@ -45,12 +46,33 @@ public:
      * @param[in] connect_timeout Timeout for connection operation.
      * @param[in] operation_timeout Subsequent I/O operation default timeout.
      * @param[in] upstream_host Hostname to check SSL-cretificate against.
+     * @param[in] profile Kernel tuning knobs applied on the underlying socket before connect.
      *
      * @throws boost::system::system_error Thrown on failure.
      */
     stream_socket(const endpoint_type& peer_endpoint, time_duration_type connect_timeout,
                   time_duration_type operation_timeout, const std::string& upstream_host,
-                  bool rfc2818_handshake = true);
+                  bool rfc2818_handshake = true,
+                  ::stream_client::socket_profile profile = ::stream_client::socket_profile());
+
+    /**
+     * Parametrized constructor with shared reactor.
+     * Same as the default one but underlying socket is multiplexed onto @p io_reactor,
+     * see ::stream_client::reactor.
+     *
+     * @param[in] io_reactor Shared reactor to run I/O and timers on.
+     * @param[in] peer_endpoint Remote endpoint to connect.
+     * @param[in] connect_timeout Timeout for connection operation.
+     * @param[in] operation_timeout Subsequent I/O operation default timeout.
+     * @param[in] upstream_host Hostname to check SSL-cretificate against.
+     * @param[in] profile Kernel tuning knobs applied on the underlying socket before connect.
+     *
+     * @throws boost::system::system_error Thrown on failure.
+     */
+    stream_socket(::stream_client::reactor& io_reactor, const endpoint_type& peer_endpoint,
+                  time_duration_type connect_timeout, time_duration_type operation_timeout,
+                  const std::string& upstream_host, bool rfc2818_handshake = true,
+                  ::stream_client::socket_profile profile = ::stream_client::socket_profile());
 
     /// Copy constructor is not permitted.
     stream_socket(const stream_socket<Socket>& other) = delete;
@@ -116,6 +138,48 @@ public:
         return handshake(connection_timeout());
     }
 
+    /**
+     * Perform SSL handshaking with TLS 1.3 0-RTT early data attached.
+     * When the stream resumes a cached session which permits early data
+     * (see detail::ssl_session_cache), @p data rides the ClientHello via
+     * SSL_write_early_data, saving one round trip before the first byte;
+     * if the server rejects the early data, or the session does not allow
+     * it, or OpenSSL is older than 1.1.1, the data is sent the regular way
+     * right after the handshake. Either way all of @p data is on the wire
+     * once the call succeeds.
+     *
+     * @note Early data is replayable by design: opt in per call and only
+     *      for idempotent payloads. Construct the stream with
+     *      rfc2818_handshake = false to keep the constructor from
+     *      handshaking on its own.
+     *
+     * @tparam Time Type of @p timeout_or_deadline, either time_duration_type or time_point_type.
+     *
+     * @param[in] data Application payload to attach to the handshake.
+     * @param[out] ec Set to indicate what error occurred, if any.
+     * @param[in] timeout_or_deadline Expiration time-point or duration.
+     *
+     * @returns Number of payload bytes sent; 0 if the handshake failed.
+     */
+    template <typename Time>
+    std::size_t handshake_with_early_data(const boost::asio::const_buffer& data, boost::system::error_code& ec,
+                                          const Time& timeout_or_deadline);
+
+    /**
+     * Perform SSL handshaking with TLS 1.3 0-RTT early data attached.
+     * Same as above but throws on failure.
+     *
+     * @tparam Time Type of @p timeout_or_deadline, either time_duration_type or time_point_type.
+     *
+     * @param[in] data Application payload to attach to the handshake.
+     * @param[in] timeout_or_deadline Expiration time-point or duration.
+     *
+     * @returns Number of payload bytes sent.
+     * @throws boost::system::system_error Thrown on failure.
+     */
+    template <typename Time>
+    std::size_t handshake_with_early_data(const boost::asio::const_buffer& data, const Time& timeout_or_deadline);
+
     /**
      * Send data through the stream.
      * The call will block until one of the following conditions is true:
@@ -345,21 +409,27 @@ public:
     /**
      * Get a const reference to the associated boost::asio::ssl::context.
      *
+     * @note The context is shared between all ssl streams in the process,
+     * see ::stream_client::ssl::detail::ssl_session_cache.
+     *
      * @returns This function returns a const reference to the ssl context.
      */
     inline const boost::asio::ssl::context& ssl_context() const
     {
-        return ssl_context_;
+        return *ssl_context_;
     }
 
     /**
      * Get a reference to the associated boost::asio::ssl::context.
      *
+     * @note The context is shared between all ssl streams in the process,
+     * see ::stream_client::ssl::detail::ssl_session_cache.
+     *
      * @returns This function returns a reference to the ssl context.
      */
     inline boost::asio::ssl::context& ssl_context()
     {
-        return ssl_context_;
+        return *ssl_context_;
     }
 
     /**
@@ -510,8 +580,16 @@ protected:
     }
 
 private:
-    boost::asio::ssl::context ssl_context_; ///< Current SSL context used in stream communications.
+    /// Delegated constructor. If @p io_reactor is nullptr underlying socket owns its' io_service.
+    stream_socket(::stream_client::reactor* io_reactor, const endpoint_type& peer_endpoint,
+                  time_duration_type connect_timeout, time_duration_type operation_timeout,
+                  const std::string& upstream_host, bool rfc2818_handshake,
+                  ::stream_client::socket_profile profile);
+
+    std::shared_ptr<boost::asio::ssl::context> ssl_context_; ///< Process-shared SSL context used in stream
+                                                             ///< communications.
     std::unique_ptr<ssl_layer_type> ssl_stream_; ///< Movable boost::asio::ssl::stream handler
+    std::string upstream_host_; ///< Host used as the session resumption cache key.
 };
 
 //! SSL-encrypted TCP stream.
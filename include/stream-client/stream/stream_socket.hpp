@@ -5,6 +5,9 @@
 #include <boost/asio/basic_stream_socket.hpp>
 #include <boost/asio/ip/tcp.hpp>
 
+#include <cstdint>
+#include <vector>
+
 namespace stream_client {
 
 /**
@@ -98,6 +101,60 @@ public:
         return send(buffers, this->io_timeout());
     }
 
+    /**
+     * Send a region of an open file through the stream.
+     * On Linux the data goes through sendfile(2) straight from the page cache into the socket
+     * under a single timeout scope - no user-space copy; elsewhere it falls back to a
+     * pread(2)/send() loop through a bounded chunk. The call will block until one of the
+     * following conditions is true:
+     *
+     * @li All @p length bytes starting at @p offset have been written.
+     * @li An error or timeout occurred.
+     *
+     * @tparam Time Type of @p timeout_or_deadline, either time_duration_type or time_point_type.
+     *
+     * @param[in] fd Descriptor of the file to send, must be open for reading.
+     * @param[in] offset Offset in the file to start sending from. The descriptor's
+     *      own file position is neither used nor changed.
+     * @param[in] length Number of bytes to send.
+     * @param[out] ec Set to indicate what error occurred, if any. Set to
+     *      boost::asio::error::eof if the file ended before @p length bytes were sent.
+     * @param[in] timeout_or_deadline Expiration time-point or duration.
+     *
+     * @returns The number of bytes transferred.
+     */
+    template <typename Time>
+    std::size_t send_file(int fd, std::uint64_t offset, std::size_t length, boost::system::error_code& ec,
+                          const Time& timeout_or_deadline);
+
+    /**
+     * Send a region of an open file through the stream.
+     * Same as above but throws on failure.
+     *
+     * @tparam Time Type of @p timeout_or_deadline, either time_duration_type or time_point_type.
+     *
+     * @param[in] fd Descriptor of the file to send, must be open for reading.
+     * @param[in] offset Offset in the file to start sending from.
+     * @param[in] length Number of bytes to send.
+     * @param[in] timeout_or_deadline Expiration time-point or duration.
+     *
+     * @returns The number of bytes transferred.
+     * @throws boost::system::system_error Thrown on failure.
+     */
+    template <typename Time>
+    std::size_t send_file(int fd, std::uint64_t offset, std::size_t length, const Time& timeout_or_deadline);
+
+    /// Alias to send_file() using current I/O timeout value.
+    inline std::size_t send_file(int fd, std::uint64_t offset, std::size_t length, boost::system::error_code& ec)
+    {
+        return send_file(fd, offset, length, ec, this->io_timeout());
+    }
+    /// Alias to send_file() using current I/O timeout value.
+    inline std::size_t send_file(int fd, std::uint64_t offset, std::size_t length)
+    {
+        return send_file(fd, offset, length, this->io_timeout());
+    }
+
     /**
      * Receive data through the stream.
      * The call will block until one of the following conditions is true:
@@ -248,7 +305,60 @@ public:
         return read_some(buffers, this->io_timeout());
     }
 
+    /**
+     * Enable or disable the syscall fast path for synchronous I/O.
+     * With the fast path on, send(), receive(), write_some() and read_some() try the
+     * plain non-blocking syscall on the underlying socket first and engage the reactor
+     * (timers, handler allocation, epoll) only when the socket would block. When data
+     * already sits in the kernel buffers - the common case of request/response traffic -
+     * the operation completes in a single syscall.
+     *
+     * @note Puts the underlying socket into non-blocking mode, so raw synchronous
+     *      operations done directly on next_layer() will return
+     *      boost::asio::error::would_block instead of blocking.
+     *
+     * @param[in] enabled Whether to use the fast path.
+     */
+    inline void set_io_fast_path(bool enabled)
+    {
+        boost::system::error_code ec;
+        this->next_layer().non_blocking(enabled, ec);
+        io_fast_path_ = enabled && !ec;
+    }
+
+    /**
+     * Check if the syscall fast path is enabled, see set_io_fast_path().
+     *
+     * @returns true if synchronous operations try a non-blocking syscall first.
+     */
+    inline bool io_fast_path() const
+    {
+        return io_fast_path_;
+    }
+
 private:
+    /// Syscall-first send() used when the fast path is enabled.
+    template <typename ConstBufferSequence, typename Time>
+    std::size_t fast_send(const ConstBufferSequence& buffers, boost::system::error_code& ec,
+                          const Time& timeout_or_deadline);
+
+    /// Syscall-first receive() used when the fast path is enabled.
+    template <typename MutableBufferSequence, typename Time>
+    std::size_t fast_receive(const MutableBufferSequence& buffers, boost::system::error_code& ec,
+                             const Time& timeout_or_deadline);
+
+    /// Advance past @p consumed leading bytes in the buffer list a fast-path loop
+    /// iterates over; fully consumed buffers become zero-length entries in place.
+    template <typename BufferType>
+    static void consume_buffers(std::vector<BufferType>& pending, std::size_t consumed);
+    /**
+     * Block until the underlying socket becomes readable/writable under the current deadline.
+     *
+     * @param[in] wait_type Readiness to wait for.
+     * @param[out] ec Set to indicate what error occurred, if any.
+     */
+    void wait_ready(boost::asio::socket_base::wait_type wait_type, boost::system::error_code& ec);
+
     /// Start an asynchronous send with timeout on the underlying socket.
     template <typename ConstBufferSequence, typename WriteHandler, typename Time>
     void async_send(const ConstBufferSequence& buffers, const Time& timeout_or_deadline, WriteHandler&& handler,
@@ -266,6 +376,8 @@ private:
     /// Start an asynchronous read_some with timeout on the underlying socket.
     template <typename MutableBufferSequence, typename ReadHandler, typename Time>
     void async_read_some(const MutableBufferSequence& buffers, const Time& timeout_or_deadline, ReadHandler&& handler);
+
+    bool io_fast_path_{false}; ///< Whether synchronous operations try a non-blocking syscall first.
 };
 
 //! Plain TCP stream.
@@ -0,0 +1,209 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace stream_client {
+
+// Forward declaration
+class trace_sink;
+
+namespace detail {
+
+/// Get global trace sink instance; nullptr means tracing is off.
+inline std::shared_ptr<trace_sink> tracer_instance();
+
+/// Set global trace sink instance; pass nullptr to turn tracing off.
+inline void tracer_instance(std::shared_ptr<trace_sink> new_sink);
+
+} // namespace detail
+
+/**
+ * Lifecycle phases reported by the tracing hooks.
+ * Each phase covers one potentially slow step on the way to a served request,
+ * so a span stream can attribute tail latency to DNS, connect, TLS, pool wait
+ * or the request exchange itself.
+ */
+enum class trace_phase : std::uint8_t
+{
+    resolve = 0, ///< DNS resolution, see base_resolver::resolve().
+    connect, ///< Plain socket connect, see stream_socket constructor.
+    tls_handshake, ///< TLS handshake, see ssl_stream_socket constructor.
+    pool_wait, ///< Waiting for a pooled session, see base_connection_pool::get_session().
+    request, ///< Full request/response exchange, see http::base_socket::perform().
+};
+
+/**
+ * Fixed-size POD record describing one completed lifecycle phase.
+ * Timestamps are steady-clock nanoseconds since the clock's epoch, so
+ * durations and cross-span ordering are meaningful within one process.
+ */
+struct trace_span
+{
+    trace_phase phase; ///< Which lifecycle phase the span covers.
+    std::uint32_t endpoint; ///< Endpoint (e.g. shard) index if the site knows one, 0 otherwise.
+    std::int32_t error; ///< boost error code value() the phase finished with, 0 on success.
+    std::uint64_t start_ns; ///< Steady-clock time the phase started.
+    std::uint64_t end_ns; ///< Steady-clock time the phase finished.
+};
+
+/**
+ * Sink interface receiving trace spans from the library hot paths.
+ * Implementations must be cheap and non-blocking: record() is called from
+ * latency-critical code with the span on the stack.
+ *
+ * @note Implementations must be thread-safe.
+ */
+class trace_sink
+{
+public:
+    /// Destructor.
+    virtual ~trace_sink() = default;
+
+    /**
+     * Consume one completed span.
+     *
+     * @param[in] span The record; valid only for the duration of the call.
+     */
+    virtual void record(const trace_span& span) noexcept = 0;
+};
+
+/**
+ * Bounded lock-free sink keeping the latest spans in a ring.
+ * Writers claim slots with a relaxed atomic increment and copy the span in;
+ * a concurrent snapshot() may observe a slot mid-copy, which is acceptable
+ * for the scraping use-case this sink serves.
+ */
+class ring_trace_sink: public trace_sink
+{
+public:
+    /// Construct a ring holding up to @p capacity most recent spans.
+    explicit ring_trace_sink(std::size_t capacity)
+        : spans_(capacity)
+    {
+    }
+
+    /// Store the span, overwriting the oldest one once the ring is full.
+    virtual void record(const trace_span& span) noexcept override
+    {
+        const auto slot = next_slot_.fetch_add(1, std::memory_order_relaxed) % spans_.size();
+        spans_[slot] = span;
+    }
+
+    /**
+     * Copy out the currently stored spans, oldest first.
+     *
+     * @returns Up to capacity spans recorded so far.
+     */
+    std::vector<trace_span> snapshot() const
+    {
+        const auto recorded = next_slot_.load(std::memory_order_relaxed);
+        const auto count = (recorded < spans_.size()) ? recorded : spans_.size();
+        const auto oldest = (recorded < spans_.size()) ? 0 : recorded % spans_.size();
+        std::vector<trace_span> copy;
+        copy.reserve(count);
+        for (std::size_t i = 0; i < count; ++i) {
+            copy.push_back(spans_[(oldest + i) % spans_.size()]);
+        }
+        return copy;
+    }
+
+private:
+    std::vector<trace_span> spans_; ///< Ring storage.
+    std::atomic<std::size_t> next_slot_{0}; ///< Total spans recorded; next slot is this modulo capacity.
+};
+
+/**
+ * Set trace sink for the library.
+ * Until a sink is set (and after it is reset with nullptr) the tracing hooks
+ * reduce to a single pointer check and no clock reads.
+ *
+ * @param[in] sink Sink instance to feed with spans, or nullptr to disable tracing.
+ */
+inline void set_tracer(std::shared_ptr<trace_sink> sink)
+{
+    detail::tracer_instance(std::move(sink));
+}
+
+namespace detail {
+
+#if defined(STREAMCLIENT_DISABLE_TRACING)
+
+/// Tracing is compiled out: the scope is an empty shell optimized away entirely.
+class trace_scope
+{
+public:
+    explicit trace_scope(trace_phase) noexcept {}
+    inline void set_error(int) noexcept {}
+    inline void set_endpoint(std::uint32_t) noexcept {}
+};
+
+#else
+
+/**
+ * RAII hook marking one lifecycle phase: grabs the start timestamp on construction
+ * and emits the span to the global sink on destruction, so it survives both normal
+ * returns and exceptions thrown mid-phase.
+ * When no sink is set the constructor costs one shared_ptr load and nothing more.
+ */
+class trace_scope
+{
+public:
+    explicit trace_scope(trace_phase phase) noexcept
+        : sink_(tracer_instance())
+        , phase_(phase)
+    {
+        if (sink_) {
+            start_ = std::chrono::steady_clock::now();
+        }
+    }
+
+    trace_scope(const trace_scope&) = delete;
+    trace_scope& operator=(const trace_scope&) = delete;
+
+    ~trace_scope()
+    {
+        if (!sink_) {
+            return;
+        }
+        trace_span span;
+        span.phase = phase_;
+        span.endpoint = endpoint_;
+        span.error = error_;
+        span.start_ns = static_cast<std::uint64_t>(
+            std::chrono::duration_cast<std::chrono::nanoseconds>(start_.time_since_epoch()).count());
+        span.end_ns = static_cast<std::uint64_t>(
+            std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch())
+                .count());
+        sink_->record(span);
+    }
+
+    /// Attach the error code value the phase finished with.
+    inline void set_error(int error_value) noexcept
+    {
+        error_ = error_value;
+    }
+
+    /// Attach an endpoint (e.g. shard) index if the call site knows one.
+    inline void set_endpoint(std::uint32_t endpoint) noexcept
+    {
+        endpoint_ = endpoint;
+    }
+
+private:
+    std::shared_ptr<trace_sink> sink_; ///< Sink captured once at phase start.
+    trace_phase phase_; ///< Phase being measured.
+    std::uint32_t endpoint_{0}; ///< Optional endpoint index.
+    std::int32_t error_{0}; ///< Error value the phase finished with.
+    std::chrono::steady_clock::time_point start_; ///< Phase start, set only when a sink is active.
+};
+
+#endif // defined(STREAMCLIENT_DISABLE_TRACING)
+
+} // namespace detail
+} // namespace stream_client
+
+#include "impl/tracer.ipp"
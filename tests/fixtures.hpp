@@ -96,6 +96,17 @@ public:
                                                        stream_client::connector::greedy_strategy<connector_type>>;
 };
 
+template <typename Server>
+class LockfreePoolServerEnv: public ServerEnv<Server>
+{
+public:
+    using connector_type = typename Server::connector_type;
+    using client_pool_type =
+        stream_client::connector::base_connection_pool<connector_type,
+                                                       stream_client::connector::greedy_strategy<connector_type>,
+                                                       stream_client::connector::mpmc_pool_storage<connector_type>>;
+};
+
 template <typename Server>
 class ConservativePoolServerEnv: public ServerEnv<Server>
 {
@@ -106,6 +117,16 @@ public:
                                                        stream_client::connector::conservative_strategy<connector_type>>;
 };
 
+template <typename Server>
+class AdaptivePoolServerEnv: public ServerEnv<Server>
+{
+public:
+    using connector_type = typename Server::connector_type;
+    using client_pool_type =
+        stream_client::connector::base_connection_pool<connector_type,
+                                                       stream_client::connector::adaptive_strategy<connector_type>>;
+};
+
 using TCPUDPServerTypes = ::testing::Types<::utils::tcp_server<1>, ::utils::udp_server>;
 using AllServerTypes = ::testing::Types<::utils::tcp_server<1>, ::utils::udp_server, ::utils::ssl_server<1>>;
 using PoolServerTypes =
@@ -114,6 +135,8 @@ using PoolServerTypes =
 TYPED_TEST_SUITE(ServerEnv, AllServerTypes);
 TYPED_TEST_SUITE(ConservativePoolServerEnv, PoolServerTypes);
 TYPED_TEST_SUITE(GreedyPoolServerEnv, PoolServerTypes);
+TYPED_TEST_SUITE(LockfreePoolServerEnv, PoolServerTypes);
+TYPED_TEST_SUITE(AdaptivePoolServerEnv, PoolServerTypes);
 TYPED_TEST_SUITE(ConnectedEnv, AllServerTypes);
 TYPED_TEST_SUITE(TCPUDPConnectedEnv, TCPUDPServerTypes);
 
@@ -43,6 +43,117 @@ TYPED_TEST(ServerEnv, Connect)
                        ssl_short_read_err);
 }
 
+TEST(SslSessionCache, ResumedHandshake)
+{
+    using client_type = ::stream_client::ssl::ssl_client;
+    using endpoint_type = boost::asio::ip::tcp::endpoint;
+
+    const endpoint_type server_endpoint(boost::asio::ip::address::from_string("127.0.0.1"), 6666);
+    ::utils::ssl_server<2> server(server_endpoint);
+
+    // first connection does a full handshake and populates the session cache
+    {
+        auto future_session = server.get_session();
+        auto client_session = utils::make_unique_client<client_type>(server_endpoint, std::chrono::seconds(1),
+                                                                     std::chrono::seconds(1), "localhost");
+        auto server_session = future_session.get();
+        EXPECT_FALSE(SSL_session_reused(client_session->native_handle()));
+
+        // roundtrip makes the client consume post-handshake session tickets (TLS 1.3)
+        server_session.do_echo(4, true);
+        std::string data = "ping";
+        client_session->send(boost::asio::buffer(data.data(), data.size()));
+        client_session->receive(boost::asio::buffer(&data[0], data.size()));
+
+        EXPECT_CODE_ONEOF3(client_session->close(), boost::system::errc::success,
+                           boost::asio::error::connection_reset, ssl_short_read_err);
+    }
+
+    // second connection to the same host resumes the cached session
+    {
+        auto future_session = server.get_session();
+        auto client_session = utils::make_unique_client<client_type>(server_endpoint, std::chrono::seconds(1),
+                                                                     std::chrono::seconds(1), "localhost");
+        auto server_session = future_session.get();
+        EXPECT_TRUE(SSL_session_reused(client_session->native_handle()));
+
+        EXPECT_CODE(server_session.close(), boost::system::errc::success);
+        EXPECT_CODE_ONEOF3(client_session->close(), boost::system::errc::success,
+                           boost::asio::error::connection_reset, ssl_short_read_err);
+    }
+}
+
+TEST(RecycledBufferPool, ReusesCapacity)
+{
+    auto& pool = ::stream_client::http::detail::recycled_buffer_pool::instance();
+
+    auto first = pool.acquire(1024);
+    EXPECT_EQ(first.size(), 0);
+    const std::string payload(512, 'x');
+    first.commit(boost::asio::buffer_copy(first.prepare(payload.size()), boost::asio::buffer(payload)));
+    const auto grown_capacity = first.capacity();
+    EXPECT_GE(grown_capacity, payload.size());
+    pool.release(std::move(first));
+
+    // the most recently released buffer comes back first, empty but still grown
+    auto second = pool.acquire(1024);
+    EXPECT_EQ(second.size(), 0);
+    EXPECT_GE(second.capacity(), grown_capacity);
+    pool.release(std::move(second));
+}
+
+TEST(SslEarlyData, HandshakeWithPayload)
+{
+    using client_type = ::stream_client::ssl::ssl_client;
+    using endpoint_type = boost::asio::ip::tcp::endpoint;
+
+    const endpoint_type server_endpoint(boost::asio::ip::address::from_string("127.0.0.1"), 6666);
+    ::utils::ssl_server<2> server(server_endpoint);
+
+    // first connection populates the session cache, see SslSessionCache.ResumedHandshake
+    {
+        auto future_session = server.get_session();
+        auto client_session = utils::make_unique_client<client_type>(server_endpoint, std::chrono::seconds(1),
+                                                                     std::chrono::seconds(1), "localhost");
+        auto server_session = future_session.get();
+
+        server_session.do_echo(4, true);
+        std::string data = "ping";
+        client_session->send(boost::asio::buffer(data.data(), data.size()));
+        client_session->receive(boost::asio::buffer(&data[0], data.size()));
+
+        EXPECT_CODE_ONEOF3(client_session->close(), boost::system::errc::success,
+                           boost::asio::error::connection_reset, ssl_short_read_err);
+    }
+
+    // second connection attaches the payload to the handshake; whether the
+    // server accepts the early flight or not, the bytes must arrive exactly once
+    {
+        auto future_session = server.get_session();
+        client_type client(server_endpoint, std::chrono::seconds(1), std::chrono::seconds(1), "localhost", false);
+
+        std::string send_data = "ping";
+        boost::system::error_code error;
+        std::size_t sent_bytes = 0;
+        ASSERT_NO_THROW({
+            sent_bytes = client.handshake_with_early_data(boost::asio::buffer(send_data.data(), send_data.size()),
+                                                          error, std::chrono::seconds(1));
+        });
+        EXPECT_CODE(error, boost::system::errc::success);
+        EXPECT_EQ(sent_bytes, send_data.size());
+
+        auto server_session = future_session.get();
+        server_session.do_echo(send_data.size(), true);
+
+        std::string recv_data(send_data.size(), '\0');
+        ASSERT_NO_THROW({ client.receive(boost::asio::buffer(&recv_data[0], recv_data.size())); });
+        EXPECT_EQ(send_data, recv_data);
+
+        EXPECT_CODE_ONEOF3(client.close(), boost::system::errc::success, boost::asio::error::connection_reset,
+                           ssl_short_read_err);
+    }
+}
+
 TYPED_TEST(ConnectedEnv, ClosedOps)
 {
     this->server_session->close();
@@ -84,6 +195,29 @@ TYPED_TEST(TCPUDPConnectedEnv, Endpoints)
     EXPECT_EQ(remote_endpoint, this->server_endpoint);
 }
 
+TEST(SocketProfile, AppliedBeforeConnect)
+{
+    EXPECT_FALSE(::stream_client::socket_profile().tuned());
+
+    ::stream_client::socket_profile profile;
+    profile.send_buffer_size = 256 * 1024;
+    profile.receive_buffer_size = 128 * 1024;
+    EXPECT_TRUE(profile.tuned());
+
+    // udp on linux connects without a peer, so no server is needed
+    const auto peer = boost::asio::ip::udp::endpoint(boost::asio::ip::address_v4::loopback(), 6666);
+    ::stream_client::udp_client client(peer, std::chrono::seconds(1), std::chrono::seconds(1), profile);
+    EXPECT_EQ(client.profile().send_buffer_size, profile.send_buffer_size);
+
+    // the kernel rounds SO_*BUF values up, never below the request
+    boost::asio::socket_base::send_buffer_size snd_buf;
+    ASSERT_NO_THROW(client.get_option(snd_buf));
+    EXPECT_GE(snd_buf.value(), profile.send_buffer_size);
+    boost::asio::socket_base::receive_buffer_size rcv_buf;
+    ASSERT_NO_THROW(client.get_option(rcv_buf));
+    EXPECT_GE(rcv_buf.value(), profile.receive_buffer_size);
+}
+
 int main(int argc, char** argv)
 {
     ::testing::InitGoogleTest(&argc, argv);
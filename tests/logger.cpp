@@ -188,6 +188,55 @@ TEST_P(CoutLogger, LogMessageCheck)
     }
 }
 
+TEST(AsyncLogger, DeliversInOrder)
+{
+    std::mutex sink_mutex;
+    std::vector<std::string> delivered;
+    auto downstream = std::make_shared<func_logger>(
+            log_level::trace, [&](log_level, const std::string&, const std::string& message) {
+                std::lock_guard<std::mutex> lock(sink_mutex);
+                delivered.push_back(message);
+            });
+
+    {
+        async_logger logger(log_level::trace, downstream, 1024);
+        for (int i = 0; i < 100; ++i) {
+            logger.message(log_level::info, "logger.cpp:0", "message " + std::to_string(i));
+        }
+        EXPECT_EQ(0, logger.dropped_count());
+        // destructor flushes everything still queued
+    }
+
+    std::lock_guard<std::mutex> lock(sink_mutex);
+    ASSERT_EQ(100, delivered.size());
+    for (int i = 0; i < 100; ++i) {
+        EXPECT_EQ("message " + std::to_string(i), delivered[i]);
+    }
+}
+
+TEST(AsyncLogger, DropsInsteadOfBlocking)
+{
+    std::atomic<int> delivered{0};
+    auto downstream = std::make_shared<func_logger>(
+            log_level::trace, [&](log_level, const std::string&, const std::string&) {
+                // slow sink: the tiny ring must overflow while this sleeps
+                std::this_thread::sleep_for(std::chrono::milliseconds(5));
+                ++delivered;
+            });
+
+    std::uint64_t dropped = 0;
+    {
+        async_logger logger(log_level::trace, downstream, 4);
+        for (int i = 0; i < 100; ++i) {
+            logger.message(log_level::info, "logger.cpp:0", "flood");
+        }
+        dropped = logger.dropped_count();
+    }
+
+    EXPECT_GT(dropped, 0);
+    EXPECT_EQ(100, delivered.load() + dropped);
+}
+
 static const auto AllLogLevels = ::testing::Values(log_level::trace, log_level::debug, log_level::info,
         log_level::warning, log_level::error);
 INSTANTIATE_TEST_SUITE_P(SetGetLevels, FuncLogger, AllLogLevels);
@@ -1,7 +1,12 @@
 #include "fixtures.hpp"
 #include "utils/common.hpp"
 
+#include <stream-client/connector/sharded_connection_pool.hpp>
+
+#include <boost/asio/use_future.hpp>
+
 #include <unordered_set>
+#include <vector>
 
 template <typename server_session_type, typename client_pool_type, typename protocol_type, typename client_type,
           typename Server>
@@ -40,14 +45,24 @@ void start_pool_test(ServerEnv<Server>& env)
     }
 
     if (typeid(protocol_type) == typeid(boost::asio::ip::udp)) {
-        // udp will have at least one session
+        // udp will have at least one session and may overshoot with one
+        // since pulls wake the watcher to refill immediately
         EXPECT_GE(clients.size(), 1);
-        EXPECT_LE(clients.size(), pool_size);
+        EXPECT_LE(clients.size(), pool_size + 1);
     } else {
         // tcp may overshoot or undershoot with one session
         EXPECT_GE(clients.size(), pool_size - 1);
         EXPECT_LE(clients.size(), pool_size + 1);
     }
+
+    // hot-path counters should reflect the pulls and returns made above
+    const auto pool_stats = clients_pool->get_metrics().snapshot();
+    EXPECT_GE(pool_stats.acquires, pool_size * 5);
+    EXPECT_EQ(pool_stats.acquire_misses, 0);
+    EXPECT_GE(pool_stats.returns, pool_size * 5);
+    const auto connector_stats = clients_pool->get_connector_metrics().snapshot();
+    EXPECT_GE(connector_stats.connects, 1);
+    EXPECT_GE(connector_stats.resolves, 1);
 }
 
 TYPED_TEST(GreedyPoolServerEnv, PoolConnect)
@@ -59,6 +74,15 @@ TYPED_TEST(GreedyPoolServerEnv, PoolConnect)
     start_pool_test<server_session_type, client_pool_type, protocol_type, client_type>(*this);
 }
 
+TYPED_TEST(LockfreePoolServerEnv, PoolConnect)
+{
+    using server_session_type = typename TestFixture::session_type;
+    using client_pool_type = typename TestFixture::client_pool_type;
+    using protocol_type = typename TestFixture::protocol_type;
+    using client_type = typename TestFixture::client_type;
+    start_pool_test<server_session_type, client_pool_type, protocol_type, client_type>(*this);
+}
+
 TYPED_TEST(ConservativePoolServerEnv, PoolConnect)
 {
     using server_session_type = typename TestFixture::session_type;
@@ -68,6 +92,318 @@ TYPED_TEST(ConservativePoolServerEnv, PoolConnect)
     start_pool_test<server_session_type, client_pool_type, protocol_type, client_type>(*this);
 }
 
+TYPED_TEST(AdaptivePoolServerEnv, PoolConnect)
+{
+    using server_session_type = typename TestFixture::session_type;
+    using client_pool_type = typename TestFixture::client_pool_type;
+    using protocol_type = typename TestFixture::protocol_type;
+    using client_type = typename TestFixture::client_type;
+    start_pool_test<server_session_type, client_pool_type, protocol_type, client_type>(*this);
+}
+
+TEST(AdaptiveStrategy, TargetScaling)
+{
+    using connector_type = ::stream_client::connector::tcp_connector;
+    ::stream_client::connector::adaptive_strategy<connector_type> strategy(2, 20);
+    ::stream_client::connector::pool_metrics metrics;
+
+    // first call starts from the configured size clamped into bounds
+    EXPECT_EQ(strategy.target_size(10, metrics), 10);
+
+    // idle interval: no acquires at all, target shrinks towards the lower bound
+    std::this_thread::sleep_for(std::chrono::milliseconds(1100));
+    EXPECT_EQ(strategy.target_size(10, metrics), 9);
+
+    // starved interval: misses mean clients could not get a session, target pre-grows
+    for (int i = 0; i < 100; ++i) {
+        metrics.record_acquire(false, 0);
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(1100));
+    EXPECT_EQ(strategy.target_size(10, metrics), 13);
+}
+
+TEST(AsyncApi, NewSessionAndGetSession)
+{
+    const std::string host = "localhost";
+    const unsigned short port = 6666;
+
+    // connector-level: connect runs on the shared engine, future resolves to a session
+    ::stream_client::connector::udp_connector connector(host, std::to_string(port), std::chrono::seconds(1),
+                                                        std::chrono::seconds(1), std::chrono::seconds(1));
+    auto session_future = connector.async_new_session(boost::asio::use_future);
+    std::unique_ptr<::stream_client::udp_client> new_session;
+    ASSERT_NO_THROW({ new_session = session_future.get(); });
+    ASSERT_TRUE(new_session);
+    EXPECT_TRUE(new_session->is_open());
+
+    // pool-level: completes immediately when a session is stored
+    ::stream_client::connector::udp_pool clients_pool(1, host, std::to_string(port), std::chrono::seconds(1),
+                                                      std::chrono::seconds(1), std::chrono::seconds(1));
+    boost::system::error_code error;
+    ASSERT_TRUE(clients_pool.is_connected(error, std::chrono::seconds(1)));
+    auto pool_future = clients_pool.async_get_session(boost::asio::use_future);
+    std::unique_ptr<::stream_client::udp_client> pool_session;
+    ASSERT_NO_THROW({ pool_session = pool_future.get(); });
+    ASSERT_TRUE(pool_session);
+    clients_pool.return_session(std::move(pool_session));
+}
+
+TEST(EndpointStats, TracksConnectOutcomes)
+{
+    ::stream_client::connector::udp_connector connector("localhost", "6666", std::chrono::seconds(1),
+                                                        std::chrono::seconds(1), std::chrono::seconds(1));
+    boost::system::error_code error;
+    std::unique_ptr<::stream_client::udp_client> session;
+    for (int i = 0; i < 3; ++i) {
+        session = connector.new_session(error);
+        ASSERT_CODE(error, boost::system::errc::success);
+        ASSERT_TRUE(session);
+    }
+
+    // successful connects leave an EWMA trail behind the chosen endpoint
+    const auto stats = connector.get_endpoint_stats(session->remote_endpoint());
+    ASSERT_TRUE(stats);
+    EXPECT_TRUE(stats->connected);
+    EXPECT_LT(stats->failure_rate, 0.5);
+    EXPECT_GT(stats->latency_ns, 0.0);
+
+    // an endpoint never attempted has no statistics
+    const auto cold_endpoint =
+        boost::asio::ip::udp::endpoint(boost::asio::ip::address_v4::from_string("192.0.2.1"), 1);
+    EXPECT_FALSE(connector.get_endpoint_stats(cold_endpoint));
+}
+
+TEST(SocketProfile, ThreadedThroughConnectorAndPool)
+{
+    ::stream_client::socket_profile profile;
+    profile.receive_buffer_size = 512 * 1024;
+
+    // profile is a trailing connector argument, forwarded by the pool constructors too
+    ::stream_client::connector::udp_connector connector(
+        "localhost", "6666", std::chrono::seconds(1), std::chrono::seconds(1), std::chrono::seconds(1),
+        ::stream_client::resolver::udp_resolver::kDefaultIPFamily,
+        ::stream_client::resolver::udp_resolver::kDefaultFlags, profile);
+    EXPECT_EQ(connector.get_socket_profile().receive_buffer_size, profile.receive_buffer_size);
+
+    std::unique_ptr<::stream_client::udp_client> session;
+    ASSERT_NO_THROW({ session = connector.new_session(); });
+    boost::asio::socket_base::receive_buffer_size rcv_buf;
+    ASSERT_NO_THROW(session->get_option(rcv_buf));
+    EXPECT_GE(rcv_buf.value(), profile.receive_buffer_size);
+
+    // a profile set later applies to sessions connected afterwards
+    profile.receive_buffer_size = 1024 * 1024;
+    connector.set_socket_profile(profile);
+    ASSERT_NO_THROW({ session = connector.new_session(); });
+    ASSERT_NO_THROW(session->get_option(rcv_buf));
+    EXPECT_GE(rcv_buf.value(), profile.receive_buffer_size);
+}
+
+TEST(AsyncApi, GetSessionTimeout)
+{
+    // nothing listens on this port, the pool never fills and the queued waiter expires
+    ::stream_client::connector::tcp_pool clients_pool(1, "localhost", "6667", std::chrono::milliseconds(100),
+                                                      std::chrono::milliseconds(100), std::chrono::milliseconds(100));
+    auto pool_future = clients_pool.async_get_session(boost::asio::use_future);
+    EXPECT_THROW(pool_future.get(), boost::system::system_error);
+}
+
+TEST(LifoPool, WarmSessionFirst)
+{
+    const std::string host = "localhost";
+    const unsigned short port = 6666;
+
+    // udp sessions connect without a peer, so the pool fills on its own
+    ::stream_client::connector::udp_pool clients_pool(3, ::stream_client::connector::pool_reuse_order::lifo, host,
+                                                      std::to_string(port), std::chrono::seconds(1),
+                                                      std::chrono::seconds(1), std::chrono::seconds(1));
+    boost::system::error_code error;
+    ASSERT_TRUE(clients_pool.is_connected(error, std::chrono::seconds(1)));
+
+    // a returned session must be handed out again first: it is the warmest one
+    auto first_handle = clients_pool.get_session(error, std::chrono::seconds(1));
+    ASSERT_CODE(error, boost::system::errc::success);
+    ASSERT_TRUE(first_handle);
+    const auto* warm_session = first_handle.get();
+    clients_pool.return_session(std::move(first_handle));
+
+    auto second_handle = clients_pool.get_session(error, std::chrono::seconds(1));
+    ASSERT_CODE(error, boost::system::errc::success);
+    ASSERT_TRUE(second_handle);
+    EXPECT_EQ(second_handle.get(), warm_session);
+}
+
+TEST(DeadSessionScreening, GetSession)
+{
+    const std::string host = "localhost";
+    const unsigned short port = 6666;
+    const boost::asio::ip::tcp::endpoint server_endpoint(boost::asio::ip::address::from_string("127.0.0.1"), port);
+    ::utils::tcp_server<2> server(server_endpoint);
+
+    auto first_future = server.get_session();
+    ::stream_client::connector::tcp_pool clients_pool(1, host, std::to_string(port), std::chrono::seconds(1),
+                                                      std::chrono::seconds(1), std::chrono::seconds(1));
+    auto first_server_session = first_future.get();
+    boost::system::error_code error;
+    ASSERT_TRUE(clients_pool.is_connected(error, std::chrono::seconds(1)));
+
+    // second accept slot for the replacement session the watcher will establish
+    auto second_future = server.get_session();
+    // server-side close makes the pooled session dead; FIN needs a moment to arrive
+    EXPECT_CODE(first_server_session.close(), boost::system::errc::success);
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+
+    // screening must drop the dead session and hand out a freshly established one
+    auto client_session = clients_pool.get_session(error, std::chrono::seconds(2));
+    ASSERT_CODE(error, boost::system::errc::success);
+    ASSERT_TRUE(client_session);
+    EXPECT_TRUE(client_session->is_open());
+    EXPECT_GE(clients_pool.get_metrics().snapshot().dead_evictions, 1);
+    second_future.get();
+}
+
+TEST(ShardedPool, SpreadAndReturn)
+{
+    const std::string host = "localhost";
+    // udp sessions connect without a peer, so both shards fill on their own
+    const std::vector<::stream_client::connector::udp_sharded_pool::endpoint_type> endpoints{{host, "6666"},
+                                                                                             {host, "6667"}};
+    ::stream_client::connector::udp_sharded_pool clients_pool(2, endpoints, std::chrono::seconds(1),
+                                                              std::chrono::seconds(1), std::chrono::seconds(1));
+    ASSERT_EQ(clients_pool.shard_count(), 2);
+    boost::system::error_code error;
+    ASSERT_TRUE(clients_pool.is_connected(error, std::chrono::seconds(1)));
+
+    // power-of-two-choices must touch both shards over enough draws
+    for (int i = 0; i < 50; ++i) {
+        auto client_handle = clients_pool.get_session(error, std::chrono::seconds(1));
+        ASSERT_CODE(error, boost::system::errc::success);
+        ASSERT_TRUE(client_handle);
+        EXPECT_TRUE(client_handle->is_open());
+        clients_pool.return_session(std::move(client_handle));
+    }
+    const auto first_stats = clients_pool.get_metrics(0).snapshot();
+    const auto second_stats = clients_pool.get_metrics(1).snapshot();
+    EXPECT_GE(first_stats.acquires + second_stats.acquires, 50);
+    EXPECT_GE(first_stats.acquires, 1);
+    EXPECT_GE(second_stats.acquires, 1);
+    // returned sessions went back to their shards instead of being dropped
+    EXPECT_GE(first_stats.returns + second_stats.returns, 50);
+}
+
+TEST(BackgroundScheduler, RunsAndWakesTasks)
+{
+    using scheduler_type = ::stream_client::connector::background_scheduler;
+
+    scheduler_type scheduler(1);
+    std::atomic<int> runs{0};
+    const auto task_id = scheduler.add([&runs]() {
+        ++runs;
+        // park until an explicit wake
+        return scheduler_type::time_point_type::max();
+    });
+
+    // first round runs right after registration
+    for (int i = 0; i < 100 && runs.load() < 1; ++i) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    EXPECT_EQ(runs.load(), 1);
+
+    scheduler.wake(task_id);
+    for (int i = 0; i < 100 && runs.load() < 2; ++i) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    EXPECT_EQ(runs.load(), 2);
+
+    // after remove() the task is guaranteed to never run again
+    scheduler.remove(task_id);
+    scheduler.wake(task_id);
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    EXPECT_EQ(runs.load(), 2);
+}
+
+TEST(BackgroundScheduler, ConsolidatedPools)
+{
+    const std::string host = "localhost";
+
+    // udp sessions connect without a peer; two pools and their connectors share
+    // a single scheduler thread instead of four dedicated ones
+    ::stream_client::connector::background_scheduler scheduler(1);
+    ::stream_client::connector::udp_pool first_pool(scheduler, 2, std::chrono::seconds(10), host, "6666",
+                                                    std::chrono::seconds(1), std::chrono::seconds(1),
+                                                    std::chrono::seconds(1));
+    ::stream_client::connector::udp_pool second_pool(scheduler, 2, std::chrono::seconds(10), host, "6667",
+                                                     std::chrono::seconds(1), std::chrono::seconds(1),
+                                                     std::chrono::seconds(1));
+
+    boost::system::error_code error;
+    ASSERT_TRUE(first_pool.is_connected(error, std::chrono::seconds(5)));
+    ASSERT_CODE(error, boost::system::errc::success);
+    ASSERT_TRUE(second_pool.is_connected(error, std::chrono::seconds(5)));
+    ASSERT_CODE(error, boost::system::errc::success);
+
+    // pull/return goes through notify_watcher() which wakes the shared task
+    auto client_handle = first_pool.get_session(error, std::chrono::seconds(1));
+    ASSERT_CODE(error, boost::system::errc::success);
+    ASSERT_TRUE(client_handle);
+    EXPECT_TRUE(client_handle->is_open());
+    first_pool.return_session(std::move(client_handle));
+}
+
+TEST(PoolWarmUp, FillsAndReportsReadiness)
+{
+    const std::string host = "localhost";
+    const unsigned short port = 6666;
+
+    // udp sessions connect without a peer; the conservative strategy refills only
+    // a fraction per round, so a full background fill takes several watcher rounds
+    ::stream_client::connector::udp_conservative_pool clients_pool(10, host, std::to_string(port),
+                                                                   std::chrono::seconds(1), std::chrono::seconds(1),
+                                                                   std::chrono::seconds(1));
+    boost::system::error_code error;
+    ASSERT_TRUE(clients_pool.warm_up(error, std::chrono::seconds(5)));
+    EXPECT_CODE(error, boost::system::errc::success);
+    EXPECT_GE(clients_pool.current_size(), 10u);
+
+    // the pool is full, any readiness level completes immediately
+    EXPECT_TRUE(clients_pool.wait_ready(0.5, error, std::chrono::milliseconds(1)));
+    EXPECT_CODE(error, boost::system::errc::success);
+}
+
+TEST(PoolWarmUp, WaitReadyTimeout)
+{
+    // nothing listens on this port, the pool never fills
+    ::stream_client::connector::tcp_pool clients_pool(2, "localhost", "6667", std::chrono::milliseconds(100),
+                                                      std::chrono::milliseconds(100), std::chrono::milliseconds(100));
+    boost::system::error_code error;
+    EXPECT_FALSE(clients_pool.wait_ready(1.0, error, std::chrono::milliseconds(200)));
+    EXPECT_CODE(error, boost::asio::error::timed_out);
+}
+
+TEST(RacingConnector, NewSession)
+{
+    const std::string host = "localhost";
+    const unsigned short port = 6666;
+    const boost::asio::ip::tcp::endpoint server_endpoint(boost::asio::ip::address::from_string("127.0.0.1"), port);
+    ::utils::tcp_server<2> server(server_endpoint);
+
+    ::stream_client::connector::tcp_connector connector(host, std::to_string(port), std::chrono::seconds(1),
+                                                        std::chrono::seconds(1), std::chrono::seconds(1));
+    connector.set_connect_race(2, std::chrono::milliseconds(50));
+    EXPECT_EQ(connector.get_connect_race_candidates(), 2);
+
+    for (int i = 0; i < 2; ++i) {
+        auto future_session = server.get_session();
+        boost::system::error_code error;
+        auto client_session = connector.new_session(error, std::chrono::seconds(1));
+        ASSERT_CODE(error, boost::system::errc::success);
+        ASSERT_TRUE(client_session);
+        EXPECT_TRUE(client_session->is_open());
+        auto server_session = future_session.get();
+        EXPECT_CODE(server_session.close(), boost::system::errc::success);
+    }
+}
+
 int main(int argc, char** argv)
 {
     ::testing::InitGoogleTest(&argc, argv);
@@ -0,0 +1,83 @@
+#include "fixtures.hpp"
+#include "utils/common.hpp"
+
+TEST_F(TCPServerEnv, ReactorEcho)
+{
+    auto future_session = this->server.get_session();
+    stream_client::reactor io_reactor;
+
+    std::unique_ptr<stream_client::tcp_client> client;
+    ASSERT_NO_THROW({
+        client = std::make_unique<stream_client::tcp_client>(io_reactor, this->server_endpoint,
+                                                             std::chrono::milliseconds(1000),
+                                                             std::chrono::milliseconds(1000));
+    });
+    auto server_session = std::make_unique<session_type>(future_session.get());
+
+    std::string send_data = "shared reactor echo data";
+    std::string recv_data(send_data.size(), '\0');
+    server_session->do_echo(send_data.size());
+
+    size_t send_bytes = 0;
+    ASSERT_NO_THROW({ send_bytes = client->send(boost::asio::buffer(send_data.data(), send_data.size())); });
+    EXPECT_EQ(send_bytes, send_data.size());
+
+    size_t recv_bytes = 0;
+    ASSERT_NO_THROW({ recv_bytes = client->receive(boost::asio::buffer(&recv_data[0], send_bytes)); });
+    EXPECT_EQ(recv_bytes, send_data.size());
+    EXPECT_EQ(send_data, recv_data);
+}
+
+TEST_F(TCPServerEnv, ReactorReceiveTimeout)
+{
+    auto future_session = this->server.get_session();
+    stream_client::reactor io_reactor;
+
+    stream_client::tcp_client client(io_reactor, this->server_endpoint, std::chrono::milliseconds(1000),
+                                     std::chrono::milliseconds(100));
+    auto server_session = std::make_unique<session_type>(future_session.get());
+
+    // nothing is echoed back, receive has to hit operation timeout
+    boost::system::error_code error;
+    char byte = '\0';
+    client.receive(boost::asio::buffer(&byte, 1), error);
+    EXPECT_CODE(error, boost::asio::error::timed_out);
+}
+
+using ReactorPoolEnv = ServerEnv<::utils::tcp_server<boost::asio::ip::tcp::socket::max_connections>>;
+
+TEST_F(ReactorPoolEnv, ReactorSharedByPool)
+{
+    const size_t pool_size = 4;
+    std::vector<std::future<session_type>> future_sessions;
+    for (size_t i = 0; i < pool_size; ++i) {
+        future_sessions.emplace_back(this->server.get_session());
+    }
+
+    stream_client::reactor io_reactor;
+    stream_client::connector::tcp_pool clients_pool(pool_size, io_reactor, this->host, std::to_string(this->port),
+                                                    std::chrono::seconds(1), std::chrono::seconds(1),
+                                                    std::chrono::seconds(1));
+
+    std::vector<session_type> server_sessions;
+    for (size_t i = 0; i < pool_size; ++i) {
+        server_sessions.emplace_back(future_sessions[i].get());
+    }
+
+    boost::system::error_code error;
+    EXPECT_TRUE(clients_pool.is_connected(error));
+    EXPECT_CODE(error, boost::system::errc::success);
+
+    for (size_t i = 0; i < pool_size * 2; ++i) {
+        auto client_handle = clients_pool.get_session(error);
+        ASSERT_CODE(error, boost::system::errc::success);
+        EXPECT_TRUE(client_handle->is_open());
+        clients_pool.return_session(std::move(client_handle));
+    }
+}
+
+int main(int argc, char** argv)
+{
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
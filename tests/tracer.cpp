@@ -0,0 +1,56 @@
+#include "gtest/gtest.h"
+
+#include <algorithm>
+
+#include "stream-client/connector/connector.hpp"
+#include "stream-client/tracer.hpp"
+
+using namespace stream_client;
+
+TEST(RingTraceSink, Wraparound)
+{
+    ring_trace_sink sink(3);
+    for (std::uint32_t i = 0; i < 5; ++i) {
+        trace_span span{};
+        span.phase = trace_phase::connect;
+        span.endpoint = i;
+        sink.record(span);
+    }
+
+    // only the 3 most recent spans survive, oldest first
+    const auto spans = sink.snapshot();
+    ASSERT_EQ(spans.size(), 3);
+    EXPECT_EQ(spans[0].endpoint, 2);
+    EXPECT_EQ(spans[1].endpoint, 3);
+    EXPECT_EQ(spans[2].endpoint, 4);
+}
+
+TEST(TraceHooks, ResolveAndConnect)
+{
+    auto sink = std::make_shared<ring_trace_sink>(64);
+    set_tracer(sink);
+
+    // udp sessions connect without a peer, so resolve + connect spans appear unconditionally
+    ::stream_client::connector::udp_connector connector("localhost", "6666", std::chrono::seconds(1),
+                                                        std::chrono::seconds(1), std::chrono::seconds(1));
+    boost::system::error_code ec;
+    auto session = connector.new_session(ec, std::chrono::seconds(1));
+    set_tracer(nullptr);
+    ASSERT_FALSE(ec);
+    ASSERT_TRUE(session);
+
+    const auto spans = sink->snapshot();
+    const auto has_phase = [&spans](trace_phase phase) {
+        return std::any_of(spans.begin(), spans.end(), [phase](const trace_span& span) {
+            return span.phase == phase && span.error == 0 && span.end_ns >= span.start_ns;
+        });
+    };
+    EXPECT_TRUE(has_phase(trace_phase::resolve));
+    EXPECT_TRUE(has_phase(trace_phase::connect));
+}
+
+int main(int argc, char** argv)
+{
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
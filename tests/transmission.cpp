@@ -1,6 +1,11 @@
 #include "fixtures.hpp"
 #include "utils/common.hpp"
 
+#include <boost/asio/use_future.hpp>
+
+#include <cstdlib>
+#include <unistd.h>
+
 TYPED_TEST(ConnectedEnv, Echo)
 {
     // echo of send_data.size() bytes
@@ -34,6 +39,249 @@ TEST_F(HTTPConnectedEnv, Echo)
     EXPECT_EQ(response.body(), request.body());
 }
 
+TEST_F(HTTPConnectedEnv, AsyncEcho)
+{
+    this->server_session->do_echo();
+
+    boost::beast::http::request<boost::beast::http::string_body> request(boost::beast::http::verb::post, "localhost",
+                                                                         11, "test");
+    request.prepare_payload();
+
+    auto future_response = this->client_session->async_perform(request, boost::asio::use_future);
+    boost::optional<boost::beast::http::response<boost::beast::http::string_body>> response;
+    ASSERT_NO_THROW({ response = future_response.get(); });
+    ASSERT_TRUE(response);
+    EXPECT_EQ(response->result(), boost::beast::http::status::ok);
+    EXPECT_EQ(response->version(), request.version());
+    EXPECT_EQ(response->body(), request.body());
+}
+
+TEST_F(HTTPConnectedEnv, EchoRepeated)
+{
+    // several perform() calls reuse the same socket, parser buffer and header arena
+    for (int i = 0; i < 3; ++i) {
+        this->server_session->do_echo();
+
+        boost::beast::http::request<boost::beast::http::string_body> request(
+            boost::beast::http::verb::post, "localhost", 11, "test #" + std::to_string(i));
+        request.prepare_payload();
+
+        boost::beast::http::response<boost::beast::http::string_body> response;
+        ASSERT_NO_THROW({ response = this->client_session->perform(request); });
+        EXPECT_EQ(response.result(), boost::beast::http::status::ok);
+        EXPECT_EQ(response.body(), request.body());
+    }
+}
+
+TEST_F(HTTPConnectedEnv, EchoBatch)
+{
+    const size_t batch_size = 5;
+    this->server_session->do_echo_pipeline(batch_size);
+
+    std::vector<boost::beast::http::request<boost::beast::http::string_body>> requests;
+    for (size_t i = 0; i < batch_size; ++i) {
+        requests.emplace_back(boost::beast::http::verb::post, "localhost", 11, "batch #" + std::to_string(i));
+        requests.back().prepare_payload();
+    }
+
+    const auto responses = this->client_session->perform_batch(requests, this->error);
+    EXPECT_CODE(this->error, boost::system::errc::success);
+    ASSERT_EQ(responses.size(), batch_size);
+    for (size_t i = 0; i < batch_size; ++i) {
+        EXPECT_EQ(responses[i].result(), boost::beast::http::status::ok);
+        EXPECT_EQ(responses[i].body(), requests[i].body());
+    }
+}
+
+TEST_F(HTTPConnectedEnv, EchoStreamParser)
+{
+    this->server_session->do_echo();
+
+    boost::beast::http::request<boost::beast::http::string_body> request(boost::beast::http::verb::post, "localhost",
+                                                                         11, std::string(1000, 'x'));
+    request.prepare_payload();
+
+    // response is drained into a caller-provided parser instead of the internal one
+    boost::beast::http::response_parser<boost::beast::http::string_body> parser;
+    parser.eager(true);
+    this->client_session->perform(request, parser, this->error);
+    EXPECT_CODE(this->error, boost::system::errc::success);
+    EXPECT_EQ(parser.get().result(), boost::beast::http::status::ok);
+    EXPECT_EQ(parser.get().body(), request.body());
+}
+
+TEST_F(HTTPConnectedEnv, EchoStreamChunks)
+{
+    this->server_session->do_echo();
+
+    boost::beast::http::request<boost::beast::http::string_body> request(boost::beast::http::verb::post, "localhost",
+                                                                         11, std::string(100000, 'x'));
+    request.prepare_payload();
+
+    std::string streamed_body;
+    boost::beast::http::response_header<> header;
+    ASSERT_NO_THROW({
+        header = this->client_session->perform_stream(request, [&streamed_body](const char* data, std::size_t size) {
+            streamed_body.append(data, size);
+        });
+    });
+    EXPECT_EQ(header.result(), boost::beast::http::status::ok);
+    EXPECT_EQ(header.version(), request.version());
+    EXPECT_EQ(streamed_body, request.body());
+}
+
+TEST_F(HTTPConnectedEnv, EchoZeroCopyView)
+{
+    this->server_session->do_echo();
+
+    boost::beast::http::request<boost::beast::http::string_body> request(boost::beast::http::verb::post, "localhost",
+                                                                         11, std::string(100000, 'y'));
+    request.prepare_payload();
+
+    ::stream_client::http::response_view view;
+    ASSERT_NO_THROW({ view = this->client_session->perform_view(request); });
+    EXPECT_EQ(view.header.result(), boost::beast::http::status::ok);
+    EXPECT_EQ(view.header.version(), request.version());
+    ASSERT_EQ(view.body.size(), request.body().size());
+    EXPECT_EQ(view.body, boost::beast::string_view(request.body()));
+
+    // the view is valid only until the next operation; the socket itself stays usable
+    this->server_session->do_echo();
+    boost::beast::http::response<boost::beast::http::string_body> response;
+    ASSERT_NO_THROW({ response = this->client_session->perform(request); });
+    EXPECT_EQ(response.result(), boost::beast::http::status::ok);
+    EXPECT_EQ(response.body(), request.body());
+}
+
+TEST_F(UDPConnectedEnv, EchoBatch)
+{
+    const size_t batch_size = 4;
+    const size_t datagram_size = 100;
+    const std::string payload(this->send_data, 0, datagram_size);
+    // each do_echo() call echoes back exactly one datagram of datagram_size bytes
+    for (size_t i = 0; i < batch_size; ++i) {
+        this->server_session->do_echo(datagram_size);
+    }
+
+    std::vector<boost::asio::const_buffer> send_buffers(batch_size,
+                                                        boost::asio::buffer(payload.data(), payload.size()));
+    const size_t sent_count = this->client_session->send_batch(send_buffers, this->error);
+    EXPECT_CODE(this->error, boost::system::errc::success);
+    ASSERT_EQ(sent_count, batch_size);
+
+    // echoes may arrive in several bursts, keep receiving until all of them are in
+    std::vector<std::string> replies(batch_size, std::string(datagram_size, '\0'));
+    size_t recv_count = 0;
+    while (recv_count < batch_size) {
+        std::vector<boost::asio::mutable_buffer> recv_buffers;
+        for (size_t i = recv_count; i < batch_size; ++i) {
+            recv_buffers.emplace_back(boost::asio::buffer(&replies[i][0], datagram_size));
+        }
+        std::vector<size_t> sizes;
+        const size_t n_received = this->client_session->receive_batch(recv_buffers, sizes, this->error);
+        ASSERT_CODE(this->error, boost::system::errc::success);
+        ASSERT_GE(n_received, 1);
+        ASSERT_EQ(sizes.size(), n_received);
+        for (const auto& size : sizes) {
+            EXPECT_EQ(size, datagram_size);
+        }
+        recv_count += n_received;
+    }
+
+    ASSERT_EQ(recv_count, batch_size);
+    for (const auto& reply : replies) {
+        EXPECT_EQ(reply, payload);
+    }
+}
+
+TEST(TcpFastOpen, Echo)
+{
+    const boost::asio::ip::tcp::endpoint server_endpoint(boost::asio::ip::address::from_string("127.0.0.1"), 6666);
+    ::utils::tcp_server<1> server(server_endpoint);
+    auto future_session = server.get_session();
+
+    ::stream_client::set_tcp_fastopen(true);
+    std::unique_ptr<::stream_client::tcp_client> client;
+    ASSERT_NO_THROW({
+        client = std::make_unique<::stream_client::tcp_client>(server_endpoint, std::chrono::seconds(1),
+                                                               std::chrono::seconds(1));
+    });
+    ::stream_client::set_tcp_fastopen(false);
+
+    // with Fast Open the SYN goes out with this first write, so it must
+    // precede the server-side accept below
+    const std::string send_data = "fastopen probe";
+    std::size_t sent_bytes = 0;
+    ASSERT_NO_THROW({ sent_bytes = client->send(boost::asio::buffer(send_data.data(), send_data.size())); });
+    EXPECT_EQ(sent_bytes, send_data.size());
+
+    auto server_session = future_session.get();
+    server_session.do_echo(send_data.size());
+
+    std::string recv_data(send_data.size(), '\0');
+    std::size_t recv_bytes = 0;
+    ASSERT_NO_THROW({ recv_bytes = client->receive(boost::asio::buffer(&recv_data[0], recv_data.size())); });
+    EXPECT_EQ(recv_bytes, send_data.size());
+    EXPECT_EQ(send_data, recv_data);
+}
+
+TEST_F(TCPConnectedEnv, EchoFastPath)
+{
+    this->client_session->set_io_fast_path(true);
+    EXPECT_TRUE(this->client_session->io_fast_path());
+
+    // echo of send_data.size() bytes
+    this->server_session->do_echo(this->send_data.size());
+
+    ASSERT_NO_THROW({
+        this->send_bytes =
+            this->client_session->send(boost::asio::buffer(this->send_data.data(), this->send_data.size()));
+    });
+    EXPECT_EQ(this->send_bytes, this->send_data.size());
+
+    // the echo may not have arrived yet: the first read exercises the reactor
+    // fallback, the rest is drained by the non-blocking syscall loop
+    ASSERT_NO_THROW({
+        this->recv_bytes = this->client_session->receive(boost::asio::buffer(&this->recv_data[0], this->send_bytes));
+    });
+    EXPECT_EQ(this->recv_bytes, this->send_data.size());
+    EXPECT_EQ(this->send_data, this->recv_data);
+
+    // a read on an idle socket must still honour the timeout
+    char extra = 0;
+    this->recv_bytes =
+        this->client_session->receive(boost::asio::buffer(&extra, 1), this->error, std::chrono::milliseconds(100));
+    EXPECT_EQ(this->recv_bytes, 0);
+    EXPECT_CODE(this->error, boost::asio::error::timed_out);
+}
+
+TEST_F(TCPConnectedEnv, EchoSendFile)
+{
+    // stage send_data in an unlinked temporary file
+    char file_template[] = "/tmp/stream-client-sendfile-XXXXXX";
+    const int fd = ::mkstemp(file_template);
+    ASSERT_GE(fd, 0);
+    ::unlink(file_template);
+    ASSERT_EQ(::write(fd, this->send_data.data(), this->send_data.size()),
+              static_cast<ssize_t>(this->send_data.size()));
+
+    this->server_session->do_echo(this->send_data.size());
+
+    ASSERT_NO_THROW({ this->send_bytes = this->client_session->send_file(fd, 0, this->send_data.size()); });
+    EXPECT_EQ(this->send_bytes, this->send_data.size());
+
+    ASSERT_NO_THROW({
+        this->recv_bytes = this->client_session->receive(boost::asio::buffer(&this->recv_data[0], this->send_bytes));
+    });
+    EXPECT_EQ(this->recv_bytes, this->send_data.size());
+    EXPECT_EQ(this->send_data, this->recv_data);
+
+    // sending past the end of the file reports EOF
+    this->client_session->send_file(fd, this->send_data.size(), 1, this->error);
+    EXPECT_CODE(this->error, boost::asio::error::eof);
+    ::close(fd);
+}
+
 TYPED_TEST(ConnectedEnv, PartialReceive)
 {
     using protocol_type = typename TestFixture::protocol_type;
@@ -217,6 +217,28 @@ public:
         return do_echo(std::chrono::milliseconds(0));
     }
 
+    void do_echo_pipeline(const size_t& count)
+    {
+        echo_threads_.emplace_back([count, this]() {
+            boost::system::error_code err_code;
+            boost::beast::flat_buffer buffer{8192};
+
+            // serve pipelined requests back-to-back on a single connection
+            for (size_t i = 0; i < count && !err_code; ++i) {
+                boost::beast::http::request<boost::beast::http::string_body> request;
+                boost::beast::http::read(*this->socket_, buffer, request, err_code);
+                if (err_code) {
+                    break;
+                }
+                boost::beast::http::response<boost::beast::http::string_body> response(boost::beast::http::status::ok,
+                                                                                       request.version(),
+                                                                                       request.body());
+                response.prepare_payload();
+                boost::beast::http::write(*this->socket_, response, err_code);
+            }
+        });
+    }
+
     boost::system::error_code close()
     {
         boost::system::error_code ec;